@@ -27,10 +27,9 @@
 
 #include <string>
 #include <vector>
-
-#ifdef _WIN32
 #include <stdint.h>
-#else
+
+#ifndef _WIN32
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -78,6 +77,52 @@ namespace ra { namespace process {
   /// <returns>Returns the list of all running processes of the system.</returns>
   ProcessIdList GetProcesses();
 
+  /// <summary>
+  /// Defines a snapshot of the process table of the system.
+  /// The snapshot is stored as a structure of arrays: the same index in each list refers to the same process.
+  /// </summary>
+  struct ProcessSnapshot {
+    ProcessIdList pids;                 // process id
+    ProcessIdList ppids;                // parent process id
+    std::vector<char> states;           // process state. See GetProcessSnapshot() for known process states.
+    std::vector<uint64_t> rss;          // resident set size in bytes
+    std::vector<uint64_t> utime;        // time spent in user mode in clock ticks
+    std::vector<uint64_t> stime;        // time spent in kernel mode in clock ticks
+    std::vector<uint64_t> start_time;   // time the process started after system boot in clock ticks
+    uint64_t ticks_per_second;          // number of clock ticks per second
+
+    ProcessSnapshot() : ticks_per_second(0) {}
+
+    /// <summary>Returns the number of processes in the snapshot.</summary>
+    inline size_t size() const { return pids.size(); }
+
+    /// <summary>Returns true if the snapshot contains no process.</summary>
+    inline bool empty() const { return pids.empty(); }
+
+    /// <summary>Removes all processes from the snapshot. The allocated buffers are kept for the next snapshot.</summary>
+    void clear();
+
+    /// <summary>Returns the index of the given process id in the snapshot. Returns ra::generics::INVALID_INDEX if not found.</summary>
+    size_t FindIndex(const processid_t & pid) const;
+  };
+
+  /// <summary>
+  /// Take a snapshot of all the processes of the system, including zombie processes.
+  /// The buffers of the given snapshot are reused which makes the function suitable for polling.
+  /// </summary>
+  /// <remarks>
+  /// On linux, the known process states are:
+  ///   D Uninterruptible sleep (usually IO)
+  ///   R Running or runnable (on run queue)
+  ///   S Interruptible sleep (waiting for an event to complete)
+  ///   T Stopped, either by a job control signal or because it is being traced.
+  ///   Z Defunct ("zombie") process, terminated but not reaped by its parent.
+  /// On Windows, only the process id and the parent process id are available. The state of all processes is reported as 'R'.
+  /// </remarks>
+  /// <param name="snapshot">The snapshot of the processes of the system.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessSnapshot(ProcessSnapshot & snapshot);
+
   /// <summary>
   /// Get the current process id.
   /// </summary>
@@ -142,6 +187,62 @@ namespace ra { namespace process {
   /// <returns>Returns true if the process was successfully terminated. Returns false otherwise.</returns>
   bool Terminate(const processid_t & pid);
 
+  /// <summary>
+  /// Defines how a process was terminated by TerminateAsync().
+  /// </summary>
+  enum TerminateResult {
+    TERMINATE_FAILED,   // the process could not be signaled. The process id is invalid or the caller is not allowed to terminate the process.
+    TERMINATE_EXITED,   // the process exited gracefully within the grace period.
+    TERMINATE_KILLED,   // the process did not exit within the grace period and was killed.
+  };
+
+  /// <summary>Defines a list of TerminateResult values.</summary>
+  typedef std::vector<TerminateResult> TerminateResultList;
+
+  /// <summary>
+  /// Terminate gracefully an existing process and kill the process if it does not exit within the given grace period.
+  /// The function never blocks the caller for longer than the grace period.
+  /// </summary>
+  /// <remarks>
+  /// On linux, the process receives SIGTERM and its termination is awaited with a pidfd (if supported by the kernel).
+  /// If the process is still running at the end of the grace period, the process receives SIGKILL and the function returns immediately.
+  /// Child processes that exited gracefully are reaped. Child processes that were killed must be reaped with WaitExit().
+  /// On Windows, the process receives WM_CLOSE and WM_QUIT messages and is killed with TerminateProcess() at the end of the grace period.
+  /// </remarks>
+  /// <param name="pid">The process id of the target process to terminate.</param>
+  /// <param name="grace_period">The maximum time in milliseconds allowed for the process to exit gracefully.</param>
+  /// <returns>Returns how the process was terminated.</returns>
+  TerminateResult TerminateAsync(const processid_t & pid, uint32_t grace_period);
+
+  /// <summary>
+  /// Terminate gracefully a list of processes and kill the processes that do not exit within the given grace period.
+  /// All processes are signaled at once and share the same grace period. See TerminateAsync() for details.
+  /// </summary>
+  /// <param name="pids">The process ids of the target processes to terminate.</param>
+  /// <param name="grace_period">The maximum time in milliseconds allowed for the processes to exit gracefully.</param>
+  /// <param name="results">How each process was terminated. The list is in the same order as the given process ids.</param>
+  /// <returns>Returns true if all processes are terminated. Returns false otherwise.</returns>
+  bool TerminateAsync(const ProcessIdList & pids, uint32_t grace_period, TerminateResultList & results);
+
+  /// <summary>
+  /// Get the given process and all its descendants.
+  /// </summary>
+  /// <param name="pid">The process id of the root process of the tree.</param>
+  /// <param name="tree">The process ids of the tree. The root process is first and each process is listed before its children.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessTree(const processid_t & pid, ProcessIdList & tree);
+
+  /// <summary>
+  /// Terminate gracefully the given process and all its descendants in a single batch.
+  /// The processes that do not exit within the given grace period are killed. See TerminateAsync() for details.
+  /// </summary>
+  /// <param name="pid">The process id of the root process of the tree.</param>
+  /// <param name="grace_period">The maximum time in milliseconds allowed for the processes to exit gracefully.</param>
+  /// <param name="pids">The process ids of the tree, descendants first.</param>
+  /// <param name="results">How each process was terminated. The list is in the same order as pids.</param>
+  /// <returns>Returns true if all processes of the tree are terminated. Returns false otherwise.</returns>
+  bool TerminateTree(const processid_t & pid, uint32_t grace_period, ProcessIdList & pids, TerminateResultList & results);
+
   /// <summary>
   /// Verify the given process id is valid.
   /// </summary>
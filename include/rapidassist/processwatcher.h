@@ -0,0 +1,121 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PROCESSWATCHER_H
+#define RA_PROCESSWATCHER_H
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines the changes of the process table between two calls to ProcessWatcher::Poll().
+  /// </summary>
+  struct ProcessDelta {
+    ProcessIdList started;  // processes that were created
+    ProcessIdList exited;   // processes that were terminated
+    ProcessIdList executed; // processes that have called exec(). Only reported in event driven mode.
+    ProcessIdList changed;  // processes which cpu time or resident set size have changed. Only reported in polling mode.
+
+    /// <summary>Removes all processes from the delta. The allocated buffers are kept for the next delta.</summary>
+    void clear();
+
+    /// <summary>Returns true if the delta contains no change.</summary>
+    bool empty() const;
+  };
+
+  /// <summary>
+  /// Tracks the process table of the system and reports only the changes between two polls.
+  /// </summary>
+  /// <remarks>
+  /// In polling mode, each call to Poll() takes a new snapshot of the process table with GetProcessSnapshot()
+  /// and compares it with the previous snapshot. All the buffers are reused between polls.
+  /// A process is reported as exited once it is removed from the process table (after its parent has reaped it).
+  ///
+  /// In event driven mode, the watcher is notified by the linux kernel proc connector (PROC_EVENT_FORK, PROC_EVENT_EXEC, PROC_EVENT_EXIT)
+  /// and Poll() only processes the pending notifications. A process is reported as exited as soon as it terminates.
+  /// The resource usage values (cpu time and resident set size) of the snapshot are not updated in this mode.
+  /// The event driven mode requires the CAP_NET_ADMIN capability. If the proc connector is not available, the watcher falls back to polling mode.
+  /// </remarks>
+  class ProcessWatcher {
+  public:
+    ProcessWatcher();
+    virtual ~ProcessWatcher();
+
+    /// <summary>
+    /// Take the initial snapshot of the process table.
+    /// </summary>
+    /// <param name="prefer_events">Use the event driven mode if available on the system.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool Start(bool prefer_events = false);
+
+    /// <summary>
+    /// Stop watching the process table.
+    /// </summary>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool Stop();
+
+    /// <summary>
+    /// Returns true if the watcher is started.
+    /// </summary>
+    /// <returns>Returns true if the watcher is started. Returns false otherwise.</returns>
+    virtual bool IsStarted() const;
+
+    /// <summary>
+    /// Returns true if the watcher is driven by the kernel proc connector instead of polling the process table.
+    /// </summary>
+    /// <returns>Returns true if the watcher is event driven. Returns false otherwise.</returns>
+    virtual bool IsEventDriven() const;
+
+    /// <summary>
+    /// Computes the changes of the process table since the previous call.
+    /// </summary>
+    /// <param name="delta">The changes of the process table.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool Poll(ProcessDelta & delta);
+
+    /// <summary>
+    /// Returns the last known state of the process table.
+    /// </summary>
+    /// <returns>Returns the last known state of the process table.</returns>
+    virtual const ProcessSnapshot & GetSnapshot() const;
+
+  private:
+    bool PollSnapshot(ProcessDelta & delta);
+    bool PollEvents(ProcessDelta & delta);
+    bool OpenEvents();
+    void CloseEvents();
+
+  private:
+    bool started_;
+    int events_fd_;
+    ProcessSnapshot current_;
+    ProcessSnapshot next_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //RA_PROCESSWATCHER_H
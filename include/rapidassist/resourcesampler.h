@@ -0,0 +1,219 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_RESOURCESAMPLER_H
+#define RA_RESOURCESAMPLER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines the resource usage of a process at a given time.
+  /// </summary>
+  struct ResourceSample {
+    double timestamp;       // time of the sample in seconds. See ra::timing::GetMicrosecondsTimer().
+    double user_time;       // cumulative time spent in user mode in seconds
+    double system_time;     // cumulative time spent in kernel mode in seconds
+    double cpu_usage;       // cpu usage since the previous sample in percent of a single cpu. Can exceed 100 for multithreaded processes.
+    uint64_t rss;           // resident set size in bytes
+    uint64_t virtual_size;  // virtual memory size in bytes
+    uint64_t read_bytes;    // cumulative number of bytes read from storage. 0 if not available.
+    uint64_t write_bytes;   // cumulative number of bytes written to storage. 0 if not available.
+  };
+
+  /// <summary>Defines a list of resource samples.</summary>
+  typedef std::vector<ResourceSample> ResourceSampleList;
+
+  /// <summary>
+  /// Defines summary statistics of a series of values.
+  /// </summary>
+  struct ResourceStatistics {
+    double min;
+    double max;
+    double avg;
+    double p50;   // median
+    double p90;   // 90th percentile
+    double p99;   // 99th percentile
+  };
+
+  /// <summary>
+  /// Defines the summary of the resource usage of a process.
+  /// </summary>
+  struct ResourceSummary {
+    processid_t pid;
+    bool running;                 // true if the process was running at the last sample
+    size_t num_samples;           // number of samples in the history
+    double cpu_time;              // total cpu time (user + kernel) in seconds at the last sample
+    uint64_t read_bytes;          // cumulative bytes read at the last sample
+    uint64_t write_bytes;         // cumulative bytes written at the last sample
+    ResourceStatistics cpu_usage; // statistics of the cpu usage in percent
+    ResourceStatistics rss;       // statistics of the resident set size in bytes
+  };
+
+  /// <summary>Defines a list of resource summaries.</summary>
+  typedef std::vector<ResourceSummary> ResourceSummaryList;
+
+  /// <summary>
+  /// Samples the cpu time, memory and io usage of a set of processes.
+  /// The samples of each process are stored in a fixed size ring buffer: once full, the oldest samples are discarded.
+  /// </summary>
+  /// <remarks>
+  /// On linux, the values are read from /proc/[pid]/stat, /proc/[pid]/statm and /proc/[pid]/io.
+  /// The io counters are only readable for processes of the same user.
+  /// The history of a process is kept after the process has exited until RemoveProcess() is called.
+  /// The class is not thread safe.
+  /// </remarks>
+  class ResourceSampler {
+  public:
+    /// <summary>
+    /// Create a sampler which keeps the given number of samples per process.
+    /// </summary>
+    /// <param name="capacity">The maximum number of samples kept per process.</param>
+    ResourceSampler(size_t capacity = 1024);
+    virtual ~ResourceSampler();
+
+    /// <summary>
+    /// Add a process to the list of sampled processes.
+    /// </summary>
+    /// <param name="pid">The process id to sample.</param>
+    /// <returns>Returns true if the process is added. Returns false if the process is already sampled.</returns>
+    virtual bool AddProcess(const processid_t & pid);
+
+    /// <summary>
+    /// Remove a process and its history from the list of sampled processes.
+    /// </summary>
+    /// <param name="pid">The process id to remove.</param>
+    /// <returns>Returns true if the process is removed. Returns false otherwise.</returns>
+    virtual bool RemoveProcess(const processid_t & pid);
+
+    /// <summary>
+    /// Returns the list of sampled processes.
+    /// </summary>
+    /// <returns>Returns the list of sampled processes.</returns>
+    virtual ProcessIdList GetProcesses() const;
+
+    /// <summary>
+    /// Set the sampling interval used by Update() and Run().
+    /// </summary>
+    /// <param name="milliseconds">The interval between two samples in milliseconds.</param>
+    virtual void SetInterval(uint32_t milliseconds);
+
+    /// <summary>
+    /// Returns the sampling interval in milliseconds.
+    /// </summary>
+    /// <returns>Returns the sampling interval in milliseconds.</returns>
+    virtual uint32_t GetInterval() const;
+
+    /// <summary>
+    /// Immediately take a sample of all running processes.
+    /// </summary>
+    /// <returns>Returns the number of processes still running.</returns>
+    virtual size_t Sample();
+
+    /// <summary>
+    /// Take a sample of all running processes if the sampling interval has elapsed since the last sample.
+    /// This function is meant to be called from an existing loop.
+    /// </summary>
+    /// <returns>Returns true if a sample was taken. Returns false otherwise.</returns>
+    virtual bool Update();
+
+    /// <summary>
+    /// Sample all processes at the sampling interval until all processes have exited or the given duration has elapsed.
+    /// </summary>
+    /// <param name="duration">The maximum sampling duration in milliseconds.</param>
+    /// <returns>Returns the number of processes still running.</returns>
+    virtual size_t Run(uint32_t duration);
+
+    /// <summary>
+    /// Get the history of a process, from the oldest to the newest sample.
+    /// </summary>
+    /// <param name="pid">The process id.</param>
+    /// <param name="samples">The samples of the process.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool GetSamples(const processid_t & pid, ResourceSampleList & samples) const;
+
+    /// <summary>
+    /// Get the summary of the resource usage of a process.
+    /// </summary>
+    /// <param name="pid">The process id.</param>
+    /// <param name="summary">The summary of the process.</param>
+    /// <returns>Returns true if the function is successful. Returns false if the process is unknown or has no sample.</returns>
+    virtual bool GetSummary(const processid_t & pid, ResourceSummary & summary) const;
+
+    /// <summary>
+    /// Get the summary of all the processes with at least one sample, sorted by decreasing cpu time.
+    /// </summary>
+    /// <returns>Returns the summary of all the processes.</returns>
+    virtual ResourceSummaryList GetSummaries() const;
+
+  private:
+    struct History {
+      ResourceSampleList samples; // ring buffer
+      size_t first;               // index of the oldest sample
+      size_t count;               // number of valid samples
+      size_t total;               // number of samples taken since the process was added
+      bool running;
+    };
+    typedef std::map<processid_t, History> HistoryMap;
+
+    size_t capacity_;
+    uint32_t interval_;
+    double last_sample_time_;
+    HistoryMap histories_;
+  };
+
+  /// <summary>
+  /// Read the current resource usage of a process.
+  /// The cpu_usage field is not computed and is set to 0.
+  /// </summary>
+  /// <param name="pid">The process id.</param>
+  /// <param name="sample">The resource usage of the process.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetResourceSample(const processid_t & pid, ResourceSample & sample);
+
+  /// <summary>
+  /// Converts a list of resource summaries to CSV. The first line contains the column names.
+  /// </summary>
+  /// <param name="summaries">The list of resource summaries.</param>
+  /// <returns>Returns the summaries as CSV.</returns>
+  std::string ToCsv(const ResourceSummaryList & summaries);
+
+  /// <summary>
+  /// Converts a list of resource summaries to a JSON array.
+  /// </summary>
+  /// <param name="summaries">The list of resource summaries.</param>
+  /// <returns>Returns the summaries as JSON.</returns>
+  std::string ToJson(const ResourceSummaryList & summaries);
+
+} //namespace process
+} //namespace ra
+
+#endif //RA_RESOURCESAMPLER_H
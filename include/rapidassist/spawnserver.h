@@ -0,0 +1,181 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_SPAWNSERVER_H
+#define RA_SPAWNSERVER_H
+
+#include <string>
+#include <map>
+
+#include "rapidassist/config.h"
+#include "rapidassist/strings.h"
+#include "rapidassist/process.h"
+
+namespace ra { namespace process {
+
+#ifndef _WIN32
+
+  /// <summary>
+  /// A pre-forked "zygote" helper process that launches new processes on behalf of the current process.
+  /// The helper is forked once by Start() and then receives launch requests over a unix socket.
+  /// Launching from the helper avoids duplicating the (potentially large) address space of the
+  /// calling process and allows running registered entry points in a new process without paying
+  /// the cost of exec() and dynamic linking.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <remarks>
+  /// Processes launched by the server are children of the helper process, not of the current process.
+  /// Their exit code must be retreived with SpawnServer::GetExitCode() or SpawnServer::WaitExit() instead of
+  /// ra::process::GetExitCode() or ra::process::WaitExit().
+  /// Start() should be called early, before the current process creates threads.
+  /// New processes inherit the environment of the current process at the time Start() was called.
+  /// The class is not thread safe.
+  /// </remarks>
+  class SpawnServer {
+  public:
+    /// <summary>
+    /// Defines an entry point function that can be executed in a new process.
+    /// The value returned by the function is the exit code of the new process.
+    /// </summary>
+    typedef int (*EntryPointFunc)(const ra::strings::StringVector & args);
+
+    /// <summary>
+    /// Defines a list of entry points identified by name.
+    /// </summary>
+    typedef std::map<std::string /*name*/, EntryPointFunc> EntryPointMap;
+
+    SpawnServer();
+    virtual ~SpawnServer();
+
+    /// <summary>
+    /// Register a function that can later be launched in a new process with SpawnEntryPoint().
+    /// Entry points must be registered before calling Start().
+    /// </summary>
+    /// <param name="name">The name of the entry point.</param>
+    /// <param name="func">The function to execute in the new process.</param>
+    /// <returns>Returns true if the entry point was registered. Returns false otherwise.</returns>
+    virtual bool RegisterEntryPoint(const std::string & name, EntryPointFunc func);
+
+    /// <summary>
+    /// Fork the helper process and wait for launch requests.
+    /// </summary>
+    /// <returns>Returns true if the server is started. Returns false otherwise.</returns>
+    virtual bool Start();
+
+    /// <summary>
+    /// Stop the helper process. Processes already launched by the server are not terminated.
+    /// </summary>
+    /// <returns>Returns true if the server is stopped. Returns false otherwise.</returns>
+    virtual bool Stop();
+
+    /// <summary>
+    /// Returns true if the helper process is started.
+    /// </summary>
+    /// <returns>Returns true if the helper process is started. Returns false otherwise.</returns>
+    virtual bool IsStarted() const;
+
+    /// <summary>
+    /// Returns the process id of the helper process.
+    /// </summary>
+    /// <returns>Returns the process id of the helper process. Returns INVALID_PROCESS_ID if the server is not started.</returns>
+    virtual processid_t GetServerProcessId() const;
+
+    /// <summary>
+    /// Start the given process with the given arguments from the given directory.
+    /// </summary>
+    /// <param name="exec_path">The path to the executable to start.</param>
+    /// <param name="default_directory">The directory to run the command from.</param>
+    /// <param name="args">The list of arguments for the new process.</param>
+    /// <param name="capture_output">Capture the standard output and standard error of the new process. See WaitExit().</param>
+    /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
+    virtual processid_t Spawn(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & args, bool capture_output = false);
+
+    /// <summary>
+    /// Start a new process which executes the given registered entry point.
+    /// The new process is forked from the helper process and does not call exec().
+    /// </summary>
+    /// <param name="name">The name of a registered entry point.</param>
+    /// <param name="args">The list of arguments given to the entry point.</param>
+    /// <param name="capture_output">Capture the standard output and standard error of the new process. See WaitExit().</param>
+    /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
+    virtual processid_t SpawnEntryPoint(const std::string & name, const ra::strings::StringVector & args, bool capture_output = false);
+
+    /// <summary>
+    /// Returns the exit code of the given process id.
+    /// The process must be terminated and must be launched by this server for the function to be successful.
+    /// If the process was terminated by a signal, the exit code is 128 plus the signal number.
+    /// </summary>
+    /// <param name="pid">The process id to verify.</param>
+    /// <param name="exitcode">The process exit code if the function is successful.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool GetExitCode(const processid_t & pid, int & exitcode);
+
+    /// <summary>
+    /// Wait for the given process termination and return the process exit code.
+    /// The process must be launched by this server for the function to be successful.
+    /// </summary>
+    /// <param name="pid">The process id to wait for.</param>
+    /// <param name="exitcode">The process exit code if the function is successful.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool WaitExit(const processid_t & pid, int & exitcode);
+
+    /// <summary>
+    /// Wait for the given process termination and return the process exit code and output streams.
+    /// The process must be launched by this server with capture_output enabled for the output streams to be returned.
+    /// </summary>
+    /// <param name="pid">The process id to wait for.</param>
+    /// <param name="exitcode">The process exit code if the function is successful.</param>
+    /// <param name="output">The content of the standard output of the process.</param>
+    /// <param name="errors">The content of the standard error of the process.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool WaitExit(const processid_t & pid, int & exitcode, std::string & output, std::string & errors);
+
+  private:
+    processid_t SendRequest(int type, const std::string & target, const std::string & directory, const ra::strings::StringVector & args, bool capture_output);
+    bool ReceiveMessage(bool blocking);
+    bool ReadOutputs(const processid_t & pid, std::string & output, std::string & errors);
+
+  private:
+    struct ChildInfo {
+      int output_fd;
+      int errors_fd;
+      bool exited;
+      int exitcode;
+    };
+    typedef std::map<processid_t, ChildInfo> ChildMap;
+
+    EntryPointMap entry_points_;
+    ChildMap children_;
+    processid_t server_pid_;
+    int socket_fd_;
+    processid_t last_spawned_pid_;
+    bool last_spawn_completed_;
+  };
+
+#endif //_WIN32
+
+} //namespace process
+} //namespace ra
+
+#endif //RA_SPAWNSERVER_H
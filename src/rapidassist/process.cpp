@@ -1,814 +1,1218 @@
-/**********************************************************************************
- * MIT License
- * 
- * Copyright (c) 2018 Antoine Beauchamp
- * 
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- * 
- * The above copyright notice and this permission notice shall be included in all
- * copies or substantial portions of the Software.
- * 
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
- * SOFTWARE.
- *********************************************************************************/
-
-#include "rapidassist/process.h"
-#include "rapidassist/filesystem.h"
-#include "rapidassist/timing.h"
-#include "rapidassist/unicode.h"
-
-#include <string>
-
-#ifdef WIN32
-//#   ifndef WIN32_LEAN_AND_MEAN
-//#   define WIN32_LEAN_AND_MEAN 1
-//#   endif
-#   include <windows.h> // for GetModuleHandleEx()
-#   undef GetCurrentDirectory
-#   include <psapi.h>
-#   pragma comment( lib, "psapi.lib" )
-#   include <Tlhelp32.h>
-#elif __linux__
-#   include <unistd.h>
-#   include <limits.h>
-#   include <sys/types.h>
-#   include <signal.h>
-#   include <spawn.h>
-#   include <sys/wait.h>
-#   include <errno.h>
-extern char **environ;
-#endif
-
-namespace ra { namespace process {
-
-  /// <summary>
-  /// Define invalid process id.
-  /// Note:
-  ///   On win32 platform, an invalid process id is defined as 0. See the following reference for details:
-  ///     - https://stackoverflow.com/questions/3232401/windows-pid-0-valid
-  ///     - https://stackoverflow.com/questions/26993596/getprocessid-returning-zero/26993697
-  ///     - https://devblogs.microsoft.com/oldnewthing/20040223-00/?p=40503
-  ///   On linux plarform, an invalid process id is defined as 0. See the following reference for details:
-  ///     - https://serverfault.com/questions/279178/what-is-the-range-of-a-pid-on-linux-and-solaris
-  ///     - https://serverfault.com/a/279180
-  /// </summary>
-  const processid_t INVALID_PROCESS_ID = (processid_t)-1;
-
-
-#ifdef _WIN32
-  ///=========================================================================================
-  ///                                 WIN32 support functions
-  ///=========================================================================================
-
-  /// <summary>
-  /// Get the list of threads of a process.
-  /// </summary>
-  /// <param name="pid">The process id of the process.</param>
-  /// <param name="tids">The list of thread ids of the process.</param>
-  /// <returns>Returns true if the list of thread is returned. Returns false otherwise.</returns>
-  bool GetThreadIds(const processid_t & pid, ProcessIdList & tids) {
-    tids.clear();
-
-    //Getting threads id of the process
-    HANDLE hThreadSnap = INVALID_HANDLE_VALUE;
-    THREADENTRY32 thread_entry;
-
-    // Take a snapshot of all running threads
-    hThreadSnap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
-    if (hThreadSnap == INVALID_HANDLE_VALUE)
-      return false;
-
-    // Fill in the size of the structure before using it.
-    thread_entry.dwSize = sizeof(THREADENTRY32);
-
-    // Retrieve information about the first thread,
-    // and exit if unsuccessful
-    if (!Thread32First(hThreadSnap, &thread_entry)) {
-      CloseHandle(hThreadSnap); // clean the snapshot object
-      return false;
-    }
-
-    // Now walk the thread list of the system,
-    // and display information about each thread
-    // associated with the specified process
-    do {
-      if (thread_entry.th32OwnerProcessID == pid) {
-        //printf( "\n\n     THREAD ID      = 0x%08X", thread_entry.th32ThreadID );
-        //printf( "\n     Base priority  = %d", thread_entry.tpBasePri );
-        //printf( "\n     Delta priority = %d", thread_entry.tpDeltaPri );
-        tids.push_back(thread_entry.th32ThreadID);
-      }
-    } while (Thread32Next(hThreadSnap, &thread_entry));
-
-    return true;
-  }
-
-  enum ExitCodeResult {
-    EXIT_CODE_SUCCESS,
-    EXIT_CODE_STILLRUNNING,
-    EXIT_CODE_FAILED
-  };
-
-  ExitCodeResult GetWin32ExitCodeResult(const processid_t & pid, DWORD & code) {
-    ExitCodeResult result = EXIT_CODE_FAILED;
-
-    //Get a handle
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
-    if (hProcess) {
-      DWORD exit_code = 0;
-      if (::GetExitCodeProcess(hProcess, &exit_code)) {
-        if (exit_code != STILL_ACTIVE) {
-          result = EXIT_CODE_SUCCESS;
-        }
-        else {
-          //Check if process is still alive
-          DWORD wait_result = ::WaitForSingleObject(hProcess, 0);
-          if (wait_result == WAIT_OBJECT_0) {
-            result = EXIT_CODE_SUCCESS;
-          }
-          else if (wait_result == WAIT_TIMEOUT) {
-            result = EXIT_CODE_STILLRUNNING;
-          }
-          else {
-            //Error
-            result = EXIT_CODE_FAILED;
-          }
-        }
-      }
-
-      CloseHandle(hProcess);
-
-      bool success = (result == EXIT_CODE_SUCCESS);
-      if (success)
-        code = exit_code;
-    }
-    return result;
-  }
-
-  typedef std::vector<HWND> HwndList;
-
-  struct FindProcessWindowsStruct {
-    HwndList * windows_ptr;
-    processid_t pid;
-  };
-
-  BOOL CALLBACK EnumWindowsProc(HWND hWnd, LPARAM lParam) {
-    DWORD process_id = 0;
-
-    if (!hWnd)
-      return TRUE;		// Not a window
-    if (lParam == NULL)
-      return TRUE;    // No FindProcessWindowsStruct pointer provided
-
-    FindProcessWindowsStruct & s = (*((FindProcessWindowsStruct*)lParam));
-
-    HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(hWnd, GWLP_HINSTANCE);
-    if (hInstance) {
-      DWORD thread_id = GetWindowThreadProcessId(hWnd, &process_id);
-      if (thread_id) {
-        HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, process_id);
-        if (hProcess) {
-          //is this the process we are looking for ?
-          if (process_id == s.pid) {
-            //add found window handle to list
-            s.windows_ptr->push_back(hWnd);
-          }
-        }
-        CloseHandle(hProcess);
-      }
-    }
-    return TRUE;
-  }
-
-  bool FindProcessWindows(const processid_t & pid, HwndList & oWindows) {
-    oWindows.clear();
-
-    FindProcessWindowsStruct s;
-    s.windows_ptr = &oWindows;
-    s.pid = pid;
-
-    bool success = (EnumWindows(EnumWindowsProc, (LPARAM)&s) == TRUE);
-    return success;
-  }
-
-  bool CloseWindows(const processid_t & pid) {
-    HwndList hWnds;
-    bool success = FindProcessWindows(pid, hWnds);
-    if (success) {
-      for (size_t i = 0; i < hWnds.size(); i++) {
-        HWND hWnd = hWnds[i];
-        //#define KEYPRESS_MACRO_FUNCTION PostMessage
-        #define KEYPRESS_MACRO_FUNCTION SendMessage
-        //success = success & (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSKEYDOWN, VK_MENU, 0) == TRUE);
-        //success = success & (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSKEYDOWN, VK_F4, 0) == TRUE);
-        //success = success && (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSCOMMAND, SC_CLOSE, 0) == TRUE);
-        KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSCOMMAND, SC_CLOSE, 0);
-      }
-      success = true;
-    }
-    return success;
-  }
-
-  bool Terminate(const processid_t & pid, DWORD iTimeoutMS) {
-    bool success = false;
-
-    //Get a handle
-    HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, pid);
-    if (hProcess) {
-      ProcessIdList thread_ids;
-      if (GetThreadIds(pid, thread_ids)) {
-        DWORD num_threads = (DWORD)thread_ids.size();
-        if (num_threads >= 1) {
-          if (iTimeoutMS != INFINITE) {
-
-            //Call WM_CLOSE & WM_QUIT on all the threads
-            DWORD thread_timeout_ms = iTimeoutMS / num_threads;
-            for (size_t thread_index = 0; thread_index < num_threads && !success; thread_index++) {
-              DWORD thread_id = thread_ids[thread_index];
-              bool post_success = (PostThreadMessage(thread_id, WM_CLOSE, 0, 0) != 0); //WM_CLOSE does not always work
-              post_success = post_success && (PostThreadMessage(thread_id, WM_QUIT, 0, 0) != 0);
-              if (post_success) {
-                DWORD wait_result = WaitForSingleObject(hProcess, thread_timeout_ms);
-                success = (wait_result == WAIT_OBJECT_0);
-
-                //Some app does not signal the thread that accepted the WM_CLOSE or WM_QUIT messages
-                if (!success)
-                  success = !IsRunning(pid);
-
-                //Some app needs to have their windows closed
-                CloseWindows(pid);
-              }
-            }
-          }
-          else {
-            //Call WM_CLOSE & WM_QUIT on all the threads
-            while (!success) {
-              for (size_t thread_index = 0; thread_index < num_threads && !success; thread_index++) {
-                DWORD thread_id = thread_ids[thread_index];
-                bool post_success = (PostThreadMessage(thread_id, WM_CLOSE, 0, 0) != 0); //WM_CLOSE does not always work
-                post_success = post_success && (PostThreadMessage(thread_id, WM_QUIT, 0, 0) != 0);
-                if (post_success) {
-                  DWORD wait_result = WaitForSingleObject(hProcess, 200);
-                  success = (wait_result == WAIT_OBJECT_0);
-
-                  //Some app does not signal the thread that accepted the WM_CLOSE or WM_QUIT messages
-                  if (!success)
-                    success = !IsRunning(pid);
-
-                  //Some app needs to have their windows closed
-                  CloseWindows(pid);
-                }
-              }
-            }
-          }
-        }
-      }
-      CloseHandle(hProcess);
-    }
-
-    return success;
-  }
-
-#else
-  ///=========================================================================================
-  ///                                 Linux support functions
-  ///=========================================================================================
-
-  /// <summary>
-  /// Get the process state of the given process id.
-  /// </summary>
-  /// <param name="pid">The process id of the process.</param>
-  /// <param name="state">The process state of the given process id.</param>
-  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
-  bool GetProcessState(const processid_t & pid, char & state) {
-    std::string stat_path = std::string("/proc/") + ra::strings::ToString(pid) + "/stat";
-    bool exists = ra::filesystem::FileExists(stat_path.c_str());
-    if (!exists)
-      return false;
-
-    FILE * f = fopen(stat_path.c_str(), "r");
-    if (!f)
-      return false;
-
-    //read first 1024 bytes
-    static const int BUFFER_SIZE = 1024;
-    char buffer[BUFFER_SIZE];
-    char * tmp = fgets(buffer, BUFFER_SIZE, f);
-    buffer[BUFFER_SIZE - 1] = '\0';
-    fclose(f);
-
-    //split each token into a list
-    ra::strings::StringVector tokens;
-    ra::strings::Split(tokens, buffer, ' ');
-
-    //assert the Minimum number of tokens
-    if (tokens.size() < 3)
-      return false; //not enough tokens
-
-    const std::string & pid_s = tokens[0];
-    const std::string & name_s = tokens[1];
-    const std::string & state_s = tokens[2];
-
-    if (state_s.size() != 1)
-      return false; //not a state
-
-    //read the process state expecting one of the following characters:
-    // D Uninterruptible sleep (usually IO)
-    // R Running or runnable (on run queue)
-    // S Interruptible sleep (waiting for an event to complete)
-    // T Stopped, either by a job control signal or because it is being traced.
-    // W paging (not valid since the 2.6.xx kernel)
-    // X dead (should never be seen)
-    // Z Defunct ("zombie") process, terminated but not reaped by its parent.
-    // I ?????
-    state = state_s[0];
-
-    return true;
-  }
-
-  /// <summary>
-  /// Define if a process is running or not.
-  /// A zombie process is not considered running.
-  /// </summary>
-  /// <param name="state">The process state process.</param>
-  /// <returns>Returns true if the process is running. Returns false otherwise.</returns>
-  bool IsRunningState(const char state) {
-    // See GetProcessState() for known process states.
-    bool running = (state == 'D' || state == 'R' || state == 'S');
-    return running;
-  }
-
-  /// <summary>
-  /// Verify if the given process id is a zombie process.
-  /// </summary>
-  /// <param name="pid">The process id of the process.</param>
-  /// <returns>Returns true if the process id is a zombie process. Returns false otherwise.</returns>
-  bool IsZombieProcess(const processid_t & pid) {
-    //read the state of the given process
-    char state = '\0';
-    if (!GetProcessState(pid, state))
-      return false; //failure to get process state
-
-    // See GetProcessState() for known process states.
-    bool zombie = (state == 'Z');
-    return zombie;
-  }
-
-#endif
-
-  std::string ToString(const ProcessIdList & processes) {
-    std::string s;
-    for (size_t i = 0; i < processes.size(); i++) {
-      processid_t pid = processes[i];
-      if (!s.empty())
-        s.append(", ");
-      s += ra::strings::ToString(pid);
-    }
-    return s;
-  }
-
-  std::string GetCurrentProcessPath() {
-    std::string path;
-#ifdef _WIN32
-    HMODULE hModule = GetModuleHandle(NULL);
-    if (hModule == NULL) {
-      int ret = GetLastError();
-      return path; //failure
-    }
-    //get the path of this process
-    char buffer[MAX_PATH] = { 0 };
-    if (!GetModuleFileName(hModule, buffer, sizeof(buffer))) {
-      int ret = GetLastError();
-      return path; //failure
-    }
-    path = buffer;
-#elif __linux__
-    //from https://stackoverflow.com/a/33249023
-    char exe_path[PATH_MAX + 1] = { 0 };
-    ssize_t len = ::readlink("/proc/self/exe", exe_path, sizeof(exe_path));
-    if (len == -1 || len == sizeof(exe_path))
-      len = 0;
-    exe_path[len] = '\0';
-    path = exe_path;
-
-    //fallback from https://stackoverflow.com/a/7052225
-    if (path.empty()) {
-      char process_id_path[32];
-      sprintf(process_id_path, "/proc/%d/exe", getpid());
-      len = ::readlink(process_id_path, exe_path, sizeof(exe_path));
-      if (len == -1 || len == sizeof(exe_path))
-        len = 0;
-      exe_path[len] = '\0';
-      path = exe_path;
-    }
-#endif
-    return path;
-  }
-
-  ProcessIdList GetProcesses() {
-    ProcessIdList processes;
-
-#ifdef _WIN32
-    //Get process ids
-    const int MAX_PROCESSES = 10000;
-    DWORD process_ids[MAX_PROCESSES];
-    DWORD process_ids_size = 0; //in bytes
-    EnumProcesses(process_ids, MAX_PROCESSES, &process_ids_size);
-    DWORD num_processes = process_ids_size / sizeof(DWORD);
-
-    //for each process
-    for (unsigned int i = 0; i < num_processes; i++) {
-      DWORD pid = process_ids[i];
-      processes.push_back(pid);
-    }
-#else
-    //list processes from the filesystem
-    ra::strings::StringVector files;
-    bool found = ra::filesystem::FindFiles(files, "/proc", 0);
-    if (!found)
-      return processes; //failed
-    for (size_t i = 0; i < files.size(); i++) {
-      const std::string & file = files[i];
-
-      //filter out files
-      bool is_directory = ra::filesystem::DirectoryExists(file.c_str());
-      if (!is_directory)
-        continue;
-
-      //filter out directories that are not numeric.
-      const std::string name = ra::filesystem::GetFilename(file.c_str());
-      bool numeric = ra::strings::IsNumeric(name.c_str());
-      if (!numeric)
-        continue;
-
-      //that's a process id. Parse it
-      processid_t pid = INVALID_PROCESS_ID;
-      bool parsed_ok = ra::strings::Parse(name.c_str(), pid);
-      if (!parsed_ok)
-        continue;
-
-      //filter out process id that are not running
-      //(i.e. zombie processes)
-      char state = '\0';
-      if (!GetProcessState(pid, state))
-        continue;
-      bool running = IsRunningState(state);
-      if (!running)
-        continue;
-
-      processes.push_back(pid);
-    }
-#endif
-
-    return processes;
-  }
-
-  processid_t GetCurrentProcessId() {
-#ifdef _WIN32
-    processid_t pid = ::GetCurrentProcessId();
-#else
-    processid_t pid = getpid();
-#endif
-    return pid;
-  }
-
-  std::string GetCurrentProcessDir() {
-    std::string dir;
-    std::string exec_path = GetCurrentProcessPath();
-    if (exec_path.empty())
-      return dir; //failure
-    dir = ra::filesystem::GetParentPath(exec_path);
-    return dir;
-  }
-
-  processid_t StartProcess(const std::string & iExecPath) {
-    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
-
-    // Launch the process from the current process current directory
-    processid_t pid = StartProcess(iExecPath, curr_dir);
-    return pid;
-  }
-
-  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory) {
-    // Launch the process with no arguments
-#ifdef _WIN32
-    processid_t pid = StartProcess(iExecPath, iDefaultDirectory, "");
-    return pid;
-#else
-    ra::strings::StringVector args;
-    processid_t pid = StartProcess(iExecPath, iDefaultDirectory, args);
-    return pid;
-#endif
-  }
-
-#ifdef _WIN32
-  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory, const std::string & iCommandLine) {
-    //build the full command line
-    std::string command;
-
-    //handle iExecPath
-    if (!iExecPath.empty()) {
-      if (iExecPath.find(" ") != std::string::npos) {
-        command += "\"";
-        command += iExecPath;
-        command += "\"";
-      }
-      else
-        command += iExecPath;
-    }
-
-    if (!command.empty()) {
-      command += " ";
-      command += iCommandLine;
-    }
-
-    //launch a new process with the command line
-    PROCESS_INFORMATION process_info = { 0 };
-    STARTUPINFO startup_info = { 0 };
-    startup_info.cb = sizeof(STARTUPINFO);
-    startup_info.dwFlags = STARTF_USESHOWWINDOW;
-    startup_info.wShowWindow = SW_SHOWDEFAULT; //SW_SHOW, SW_SHOWNORMAL
-    static const DWORD creation_flags = 0; //EXTENDED_STARTUPINFO_PRESENT
-    bool success = (CreateProcess(NULL, (char*)command.c_str(), NULL, NULL, FALSE, creation_flags, NULL, iDefaultDirectory.c_str(), &startup_info, &process_info) != 0);
-    if (success) {
-      //Wait for the application to initialize properly
-      WaitForInputIdle(process_info.hProcess, INFINITE);
-
-      //Extract the program id
-      DWORD process_id = process_info.dwProcessId;
-
-      //return the process id
-      processid_t pId = static_cast<processid_t>(process_id);
-      return pId;
-    }
-    return INVALID_PROCESS_ID;
-  }
-#else
-  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory, const ra::strings::StringVector & iArguments) {
-    //temporary change the current directory for the child process
-    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
-    if (!ra::filesystem::DirectoryExists(iDefaultDirectory.c_str()))
-      return INVALID_PROCESS_ID;
-    int chdir_result = chdir(iDefaultDirectory.c_str());
-
-    //prepare argv
-    //the first element of argv must be the executable path itself.
-    //the last element of argv must be am empty argument
-    static const int MAX_ARGUMENTS = 10240;
-    char * argv[MAX_ARGUMENTS] = { 0 };
-    argv[0] = (char*)iExecPath.c_str();
-    for (size_t i = 0; i < iArguments.size() && i < (MAX_ARGUMENTS - 2); i++) {
-      char * arg_value = (char*)iArguments[i].c_str();
-      argv[i + 1] = arg_value;
-    }
-
-    //Print arguments.
-    //printf("posix_spawn():\n");
-    //fflush(NULL);
-    //int i=0;
-    //while(argv[i])
-    //{
-    //  printf("arg[%d]=%s\n", i, argv[i]);
-    //  i++;
-    //}
-
-    pid_t child_pid = INVALID_PROCESS_ID;
-    int status = posix_spawn(&child_pid, iExecPath.c_str(), NULL, NULL, argv, environ);
-    if (status != 0)
-      child_pid = INVALID_PROCESS_ID;
-
-    //restore current directory back to the previous location
-    chdir_result = chdir(curr_dir.c_str());
-
-    return child_pid;
-  }
-#endif
-
-  bool OpenDocument(const std::string & iPath) {
-    if (!ra::filesystem::FileExists(iPath.c_str()))
-      return false; //file not found
-
-#ifdef _WIN32
-    SHELLEXECUTEINFO info = { 0 };
-
-    info.cbSize = sizeof(SHELLEXECUTEINFO);
-
-    info.fMask |= SEE_MASK_NOCLOSEPROCESS;
-    info.fMask |= SEE_MASK_NOASYNC;
-    info.fMask |= SEE_MASK_FLAG_DDEWAIT;
-
-    info.hwnd = HWND_DESKTOP;
-    info.nShow = SW_SHOWDEFAULT;
-    info.lpVerb = "open";
-    info.lpFile = iPath.c_str();
-    info.lpParameters = NULL; //arguments
-    info.lpDirectory = NULL; // default directory
-
-    BOOL success = ShellExecuteEx(&info);
-    if (success) {
-      HANDLE hProcess = info.hProcess;
-      DWORD pid = GetProcessId(hProcess);
-      return true;
-    }
-    return false;
-#else
-    const char * xdgopen_path = "/usr/bin/xdg-open";
-    if (!ra::filesystem::FileExists(xdgopen_path))
-      return false; //xdg-open not found
-
-    const ra::strings::StringVector args;
-    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
-    processid_t pid = StartProcess(xdgopen_path, curr_dir, args);
-    bool success = (pid != INVALID_PROCESS_ID);
-    return success;
-#endif
-  }
-
-  bool Kill(const processid_t & pid) {
-    bool success = false;
-#ifdef _WIN32
-    //Get a handle
-    HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
-    if (hProcess) {
-      success = (TerminateProcess(hProcess, 255) != 0);
-      CloseHandle(hProcess);
-    }
-#else
-    int kill_error = ::kill(pid, SIGKILL);
-    success = (kill_error == 0);
-
-    if (success) {
-      // call waitpid() on Linux to prevent having zombie processes.
-      int status = 0;
-      processid_t result_pid = waitpid(pid, &status, 0);
-    }
-
-#endif
-    return success;
-  }
-
-  bool IsRunning(const processid_t & pid) {
-#ifdef _WIN32
-    DWORD exit_code = 0;
-    ExitCodeResult result = GetWin32ExitCodeResult(pid, exit_code);
-    bool running = false;
-    switch (result) {
-    case EXIT_CODE_SUCCESS:
-      running = false;
-      break;
-    case EXIT_CODE_STILLRUNNING:
-      running = true;
-      break;
-    case EXIT_CODE_FAILED:
-    {
-      //set the process as not running by default
-      running = false;
-
-      //search within existing processes
-      ProcessIdList processes = GetProcesses();
-      for (size_t i = 0; i < processes.size() && running == false; i++) {
-        DWORD tmp_pid = processes[i];
-        if (tmp_pid == pid)
-          running = true;
-      }
-    }
-    break;
-    default:
-      running = false; //should not append unless GetWin32ExitCodeResult is modified without notice.
-    };
-    return running;
-#else
-    char state = '\0';
-    if (!GetProcessState(pid, state))
-      return false; //unable to find process state
-
-    // See GetProcessState() for known process states.
-    bool running = IsRunningState(state);
-    return running;
-#endif
-  }
-
-  bool Terminate(const processid_t & pid) {
-#ifdef _WIN32
-    //ask the process to exit gracefully allowing a maximum of 60 seconds to close
-    bool terminated = Terminate(pid, 60000);
-    return terminated;
-#else
-    //ask the process to exit gracefully
-    int kill_error = ::kill(pid, SIGTERM);
-    bool success = (kill_error == 0);
-
-    if (success) {
-      // call waitpid() on Linux to prevent having zombie processes.
-      int status = 0;
-      processid_t result_pid = waitpid(pid, &status, 0);
-    }
-
-    return success;
-#endif
-  }
-
-  bool GetExitCode(const processid_t & pid, int & exit_code) {
-#ifdef _WIN32
-    DWORD local_exit_code;
-    ExitCodeResult result = GetWin32ExitCodeResult(pid, local_exit_code);
-    if (result == EXIT_CODE_SUCCESS) {
-      exit_code = static_cast<int>(local_exit_code);
-      return true;
-    }
-    return false;
-#else
-    int status = 0;
-    if (waitpid(pid, &status, WNOHANG | WUNTRACED | WCONTINUED) == pid) {
-      //waitpid success
-      bool process_exited = WIFEXITED(status);
-      exit_code = WEXITSTATUS(status);
-      return true;
-    }
-    return false;
-#endif
-  }
-
-  bool WaitExit(const processid_t & pid) {
-#ifdef _WIN32
-    //Get a handle on the process
-    HANDLE hProcess = OpenProcess(SYNCHRONIZE, TRUE, pid);
-    if (hProcess) {
-      //now wait for the process termination
-      WaitForSingleObject(hProcess, INFINITE);
-
-      CloseHandle(hProcess);
-      return true;
-    }
-    return false;
-#else
-    //DISABLED THE FOLLOWING IMPLEMENTATION:
-    //  waitpid() function consumes the process exit code which disables the implementation of GetExitCode().
-    //  In other words, calling GetExitCode() will always fails after calling the waitpid() function.
-    //  This is why this function would have to also return the exit code.
-    //  
-    //  int status = 0;
-    //  if (waitpid(pid, &status, 0) == pid)
-    //  {
-    //    //waitpid success
-    //    bool process_exited = WIFEXITED( status );
-    //    int exit_code = WEXITSTATUS( status );
-    //    return true;
-    //  }
-    //  return false;
-
-    //DISABLED THE FOLLOWING IMPLEMENTATION:
-    //  Using kill() function to detect if a process is alive works great but it does not detect
-    //  when a process is done executing and enters zombie state waiting for the user to call waitpid()
-    //  to get the process exit code.
-    //
-    //  int res = ::kill(pid, 0);
-    //  while (res == 0 || (res < 0 && errno == EPERM))
-    //  {
-    //    ra::timing::Millisleep(100);
-    //    res = ::kill(pid, 0);
-    //  }
-
-    //validate if pid is valid
-    int res = ::kill(pid, 0);
-    bool valid_pid = (res == 0 || (res < 0 && errno == EPERM));
-    if (!valid_pid)
-      return false;
-
-    //wait for the process state to change
-    //this implementation is slow but does not rely on waitpid()
-    //to detect the end of the process
-    while (IsRunning(pid)) {
-      //wait a little more and verify again
-      ra::timing::Millisleep(1000);
-    }
-
-    return true;
-#endif
-  }
-
-  bool WaitExit(const processid_t & pid, int & exit_code) {
-    bool success = WaitExit(pid);
-    if (!success)
-      return false;
-
-#ifndef _WIN32
-    //also read the process exit code to remove the zombie process
-    success = GetExitCode(pid, exit_code);
-#endif
-
-    return success;
-  }
-
-} //namespace process
-} //namespace ra
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/process.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/generics.h"
+#include "rapidassist/timing.h"
+#include "rapidassist/unicode.h"
+
+#include <string>
+#include <algorithm>
+
+#ifdef WIN32
+//#   ifndef WIN32_LEAN_AND_MEAN
+//#   define WIN32_LEAN_AND_MEAN 1
+//#   endif
+#   include <windows.h> // for GetModuleHandleEx()
+#   undef GetCurrentDirectory
+#   include <psapi.h>
+#   pragma comment( lib, "psapi.lib" )
+#   include <Tlhelp32.h>
+#elif __linux__
+#   include <unistd.h>
+#   include <limits.h>
+#   include <sys/types.h>
+#   include <signal.h>
+#   include <spawn.h>
+#   include <sys/wait.h>
+#   include <sys/syscall.h>
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <dirent.h>
+#   include <stdio.h>
+#   include <string.h>
+#   include <poll.h>
+extern char **environ;
+#endif
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Define invalid process id.
+  /// Note:
+  ///   On win32 platform, an invalid process id is defined as 0. See the following reference for details:
+  ///     - https://stackoverflow.com/questions/3232401/windows-pid-0-valid
+  ///     - https://stackoverflow.com/questions/26993596/getprocessid-returning-zero/26993697
+  ///     - https://devblogs.microsoft.com/oldnewthing/20040223-00/?p=40503
+  ///   On linux plarform, an invalid process id is defined as 0. See the following reference for details:
+  ///     - https://serverfault.com/questions/279178/what-is-the-range-of-a-pid-on-linux-and-solaris
+  ///     - https://serverfault.com/a/279180
+  /// </summary>
+  const processid_t INVALID_PROCESS_ID = (processid_t)-1;
+
+
+#ifdef _WIN32
+  ///=========================================================================================
+  ///                                 WIN32 support functions
+  ///=========================================================================================
+
+  /// <summary>
+  /// Get the list of threads of a process.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="tids">The list of thread ids of the process.</param>
+  /// <returns>Returns true if the list of thread is returned. Returns false otherwise.</returns>
+  bool GetThreadIds(const processid_t & pid, ProcessIdList & tids) {
+    tids.clear();
+
+    //Getting threads id of the process
+    HANDLE hThreadSnap = INVALID_HANDLE_VALUE;
+    THREADENTRY32 thread_entry;
+
+    // Take a snapshot of all running threads
+    hThreadSnap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (hThreadSnap == INVALID_HANDLE_VALUE)
+      return false;
+
+    // Fill in the size of the structure before using it.
+    thread_entry.dwSize = sizeof(THREADENTRY32);
+
+    // Retrieve information about the first thread,
+    // and exit if unsuccessful
+    if (!Thread32First(hThreadSnap, &thread_entry)) {
+      CloseHandle(hThreadSnap); // clean the snapshot object
+      return false;
+    }
+
+    // Now walk the thread list of the system,
+    // and display information about each thread
+    // associated with the specified process
+    do {
+      if (thread_entry.th32OwnerProcessID == pid) {
+        //printf( "\n\n     THREAD ID      = 0x%08X", thread_entry.th32ThreadID );
+        //printf( "\n     Base priority  = %d", thread_entry.tpBasePri );
+        //printf( "\n     Delta priority = %d", thread_entry.tpDeltaPri );
+        tids.push_back(thread_entry.th32ThreadID);
+      }
+    } while (Thread32Next(hThreadSnap, &thread_entry));
+
+    return true;
+  }
+
+  enum ExitCodeResult {
+    EXIT_CODE_SUCCESS,
+    EXIT_CODE_STILLRUNNING,
+    EXIT_CODE_FAILED
+  };
+
+  ExitCodeResult GetWin32ExitCodeResult(const processid_t & pid, DWORD & code) {
+    ExitCodeResult result = EXIT_CODE_FAILED;
+
+    //Get a handle
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+    if (hProcess) {
+      DWORD exit_code = 0;
+      if (::GetExitCodeProcess(hProcess, &exit_code)) {
+        if (exit_code != STILL_ACTIVE) {
+          result = EXIT_CODE_SUCCESS;
+        }
+        else {
+          //Check if process is still alive
+          DWORD wait_result = ::WaitForSingleObject(hProcess, 0);
+          if (wait_result == WAIT_OBJECT_0) {
+            result = EXIT_CODE_SUCCESS;
+          }
+          else if (wait_result == WAIT_TIMEOUT) {
+            result = EXIT_CODE_STILLRUNNING;
+          }
+          else {
+            //Error
+            result = EXIT_CODE_FAILED;
+          }
+        }
+      }
+
+      CloseHandle(hProcess);
+
+      bool success = (result == EXIT_CODE_SUCCESS);
+      if (success)
+        code = exit_code;
+    }
+    return result;
+  }
+
+  typedef std::vector<HWND> HwndList;
+
+  struct FindProcessWindowsStruct {
+    HwndList * windows_ptr;
+    processid_t pid;
+  };
+
+  BOOL CALLBACK EnumWindowsProc(HWND hWnd, LPARAM lParam) {
+    DWORD process_id = 0;
+
+    if (!hWnd)
+      return TRUE;		// Not a window
+    if (lParam == NULL)
+      return TRUE;    // No FindProcessWindowsStruct pointer provided
+
+    FindProcessWindowsStruct & s = (*((FindProcessWindowsStruct*)lParam));
+
+    HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(hWnd, GWLP_HINSTANCE);
+    if (hInstance) {
+      DWORD thread_id = GetWindowThreadProcessId(hWnd, &process_id);
+      if (thread_id) {
+        HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, process_id);
+        if (hProcess) {
+          //is this the process we are looking for ?
+          if (process_id == s.pid) {
+            //add found window handle to list
+            s.windows_ptr->push_back(hWnd);
+          }
+        }
+        CloseHandle(hProcess);
+      }
+    }
+    return TRUE;
+  }
+
+  bool FindProcessWindows(const processid_t & pid, HwndList & oWindows) {
+    oWindows.clear();
+
+    FindProcessWindowsStruct s;
+    s.windows_ptr = &oWindows;
+    s.pid = pid;
+
+    bool success = (EnumWindows(EnumWindowsProc, (LPARAM)&s) == TRUE);
+    return success;
+  }
+
+  bool CloseWindows(const processid_t & pid) {
+    HwndList hWnds;
+    bool success = FindProcessWindows(pid, hWnds);
+    if (success) {
+      for (size_t i = 0; i < hWnds.size(); i++) {
+        HWND hWnd = hWnds[i];
+        //#define KEYPRESS_MACRO_FUNCTION PostMessage
+        #define KEYPRESS_MACRO_FUNCTION SendMessage
+        //success = success & (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSKEYDOWN, VK_MENU, 0) == TRUE);
+        //success = success & (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSKEYDOWN, VK_F4, 0) == TRUE);
+        //success = success && (KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSCOMMAND, SC_CLOSE, 0) == TRUE);
+        KEYPRESS_MACRO_FUNCTION(hWnd, WM_SYSCOMMAND, SC_CLOSE, 0);
+      }
+      success = true;
+    }
+    return success;
+  }
+
+  bool Terminate(const processid_t & pid, DWORD iTimeoutMS) {
+    bool success = false;
+
+    //Get a handle
+    HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, pid);
+    if (hProcess) {
+      ProcessIdList thread_ids;
+      if (GetThreadIds(pid, thread_ids)) {
+        DWORD num_threads = (DWORD)thread_ids.size();
+        if (num_threads >= 1) {
+          if (iTimeoutMS != INFINITE) {
+
+            //Call WM_CLOSE & WM_QUIT on all the threads
+            DWORD thread_timeout_ms = iTimeoutMS / num_threads;
+            for (size_t thread_index = 0; thread_index < num_threads && !success; thread_index++) {
+              DWORD thread_id = thread_ids[thread_index];
+              bool post_success = (PostThreadMessage(thread_id, WM_CLOSE, 0, 0) != 0); //WM_CLOSE does not always work
+              post_success = post_success && (PostThreadMessage(thread_id, WM_QUIT, 0, 0) != 0);
+              if (post_success) {
+                DWORD wait_result = WaitForSingleObject(hProcess, thread_timeout_ms);
+                success = (wait_result == WAIT_OBJECT_0);
+
+                //Some app does not signal the thread that accepted the WM_CLOSE or WM_QUIT messages
+                if (!success)
+                  success = !IsRunning(pid);
+
+                //Some app needs to have their windows closed
+                CloseWindows(pid);
+              }
+            }
+          }
+          else {
+            //Call WM_CLOSE & WM_QUIT on all the threads
+            while (!success) {
+              for (size_t thread_index = 0; thread_index < num_threads && !success; thread_index++) {
+                DWORD thread_id = thread_ids[thread_index];
+                bool post_success = (PostThreadMessage(thread_id, WM_CLOSE, 0, 0) != 0); //WM_CLOSE does not always work
+                post_success = post_success && (PostThreadMessage(thread_id, WM_QUIT, 0, 0) != 0);
+                if (post_success) {
+                  DWORD wait_result = WaitForSingleObject(hProcess, 200);
+                  success = (wait_result == WAIT_OBJECT_0);
+
+                  //Some app does not signal the thread that accepted the WM_CLOSE or WM_QUIT messages
+                  if (!success)
+                    success = !IsRunning(pid);
+
+                  //Some app needs to have their windows closed
+                  CloseWindows(pid);
+                }
+              }
+            }
+          }
+        }
+      }
+      CloseHandle(hProcess);
+    }
+
+    return success;
+  }
+
+#else
+  ///=========================================================================================
+  ///                                 Linux support functions
+  ///=========================================================================================
+
+  /// <summary>
+  /// Defines the values read from /proc/[pid]/stat.
+  /// </summary>
+  struct ProcessStat {
+    char state;
+    processid_t ppid;
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t start_time;
+    uint64_t rss_pages;
+  };
+
+  /// <summary>
+  /// Skip the next space separated field of a /proc/[pid]/stat buffer.
+  /// </summary>
+  inline const char * SkipStatField(const char * str, const char * end) {
+    while (str < end && *str == ' ')
+      str++;
+    while (str < end && *str != ' ')
+      str++;
+    return str;
+  }
+
+  /// <summary>
+  /// Parse the next space separated unsigned numeric field of a /proc/[pid]/stat buffer.
+  /// </summary>
+  inline const char * ParseStatField(const char * str, const char * end, uint64_t & value) {
+    while (str < end && *str == ' ')
+      str++;
+    value = 0;
+    while (str < end && *str >= '0' && *str <= '9') {
+      value = value * 10 + (uint64_t)(*str - '0');
+      str++;
+    }
+    return str;
+  }
+
+  /// <summary>
+  /// Parse the content of a /proc/[pid]/stat file without allocating memory.
+  /// See proc(5) for the description of each field.
+  /// </summary>
+  /// <param name="buffer">The content of the file.</param>
+  /// <param name="length">The length of the buffer in bytes.</param>
+  /// <param name="stat">The parsed values.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ParseProcessStat(const char * buffer, size_t length, ProcessStat & stat) {
+    //the process name (field 2) is enclosed in parentheses and may contain spaces or parentheses.
+    //the fields that follows starts after the last ')' character.
+    const char * end = buffer + length;
+    const char * str = end;
+    while (str > buffer && *(str - 1) != ')')
+      str--;
+    if (str == buffer)
+      return false;
+
+    //field 3, the process state
+    while (str < end && *str == ' ')
+      str++;
+    if (str >= end)
+      return false;
+    stat.state = *str;
+    str++;
+
+    //field 4, ppid
+    uint64_t value = 0;
+    str = ParseStatField(str, end, value);
+    stat.ppid = (processid_t)value;
+
+    //skip fields 5 to 13
+    for (int i = 5; i <= 13; i++)
+      str = SkipStatField(str, end);
+
+    //fields 14 and 15, utime and stime
+    str = ParseStatField(str, end, stat.utime);
+    str = ParseStatField(str, end, stat.stime);
+
+    //skip fields 16 to 21
+    for (int i = 16; i <= 21; i++)
+      str = SkipStatField(str, end);
+
+    //field 22, starttime
+    str = ParseStatField(str, end, stat.start_time);
+
+    //skip field 23, vsize
+    str = SkipStatField(str, end);
+
+    //field 24, rss
+    str = ParseStatField(str, end, stat.rss_pages);
+
+    return (str < end);
+  }
+
+  /// <summary>
+  /// Read and parse a /proc/[pid]/stat file.
+  /// </summary>
+  /// <param name="dir_fd">The directory file descriptor for resolving a relative path. Use AT_FDCWD for an absolute path.</param>
+  /// <param name="path">The path of the stat file.</param>
+  /// <param name="stat">The parsed values.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ReadProcessStat(int dir_fd, const char * path, ProcessStat & stat) {
+    int fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+
+    //the content of a stat file is a single line of about 300 bytes
+    char buffer[1024];
+    ssize_t length = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    if (length <= 0)
+      return false;
+
+    bool parsed = ParseProcessStat(buffer, (size_t)length, stat);
+    return parsed;
+  }
+
+  /// <summary>
+  /// Get the process state of the given process id.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="state">The process state of the given process id.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessState(const processid_t & pid, char & state) {
+    char stat_path[64];
+    snprintf(stat_path, sizeof(stat_path), "/proc/%d/stat", (int)pid);
+
+    ProcessStat stat;
+    if (!ReadProcessStat(AT_FDCWD, stat_path, stat))
+      return false;
+
+    //read the process state expecting one of the following characters:
+    // D Uninterruptible sleep (usually IO)
+    // R Running or runnable (on run queue)
+    // S Interruptible sleep (waiting for an event to complete)
+    // T Stopped, either by a job control signal or because it is being traced.
+    // W paging (not valid since the 2.6.xx kernel)
+    // X dead (should never be seen)
+    // Z Defunct ("zombie") process, terminated but not reaped by its parent.
+    // I ?????
+    state = stat.state;
+
+    return true;
+  }
+
+  /// <summary>
+  /// Directory entry returned by the getdents64 system call.
+  /// </summary>
+  struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+  };
+
+  /// <summary>
+  /// Define if a process is running or not.
+  /// A zombie process is not considered running.
+  /// </summary>
+  /// <param name="state">The process state process.</param>
+  /// <returns>Returns true if the process is running. Returns false otherwise.</returns>
+  bool IsRunningState(const char state) {
+    // See GetProcessState() for known process states.
+    bool running = (state == 'D' || state == 'R' || state == 'S');
+    return running;
+  }
+
+  /// <summary>
+  /// Verify if the given process id is a zombie process.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <returns>Returns true if the process id is a zombie process. Returns false otherwise.</returns>
+  bool IsZombieProcess(const processid_t & pid) {
+    //read the state of the given process
+    char state = '\0';
+    if (!GetProcessState(pid, state))
+      return false; //failure to get process state
+
+    // See GetProcessState() for known process states.
+    bool zombie = (state == 'Z');
+    return zombie;
+  }
+
+#endif
+
+  std::string ToString(const ProcessIdList & processes) {
+    std::string s;
+    for (size_t i = 0; i < processes.size(); i++) {
+      processid_t pid = processes[i];
+      if (!s.empty())
+        s.append(", ");
+      s += ra::strings::ToString(pid);
+    }
+    return s;
+  }
+
+  std::string GetCurrentProcessPath() {
+    std::string path;
+#ifdef _WIN32
+    HMODULE hModule = GetModuleHandle(NULL);
+    if (hModule == NULL) {
+      int ret = GetLastError();
+      return path; //failure
+    }
+    //get the path of this process
+    char buffer[MAX_PATH] = { 0 };
+    if (!GetModuleFileName(hModule, buffer, sizeof(buffer))) {
+      int ret = GetLastError();
+      return path; //failure
+    }
+    path = buffer;
+#elif __linux__
+    //from https://stackoverflow.com/a/33249023
+    char exe_path[PATH_MAX + 1] = { 0 };
+    ssize_t len = ::readlink("/proc/self/exe", exe_path, sizeof(exe_path));
+    if (len == -1 || len == sizeof(exe_path))
+      len = 0;
+    exe_path[len] = '\0';
+    path = exe_path;
+
+    //fallback from https://stackoverflow.com/a/7052225
+    if (path.empty()) {
+      char process_id_path[32];
+      sprintf(process_id_path, "/proc/%d/exe", getpid());
+      len = ::readlink(process_id_path, exe_path, sizeof(exe_path));
+      if (len == -1 || len == sizeof(exe_path))
+        len = 0;
+      exe_path[len] = '\0';
+      path = exe_path;
+    }
+#endif
+    return path;
+  }
+
+  ProcessIdList GetProcesses() {
+    ProcessIdList processes;
+
+#ifdef _WIN32
+    //Get process ids
+    const int MAX_PROCESSES = 10000;
+    DWORD process_ids[MAX_PROCESSES];
+    DWORD process_ids_size = 0; //in bytes
+    EnumProcesses(process_ids, MAX_PROCESSES, &process_ids_size);
+    DWORD num_processes = process_ids_size / sizeof(DWORD);
+
+    //for each process
+    for (unsigned int i = 0; i < num_processes; i++) {
+      DWORD pid = process_ids[i];
+      processes.push_back(pid);
+    }
+#else
+    //list processes from the filesystem
+    ProcessSnapshot snapshot;
+    bool found = GetProcessSnapshot(snapshot);
+    if (!found)
+      return processes; //failed
+
+    processes.reserve(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); i++) {
+      //filter out process id that are not running
+      //(i.e. zombie processes)
+      bool running = IsRunningState(snapshot.states[i]);
+      if (!running)
+        continue;
+
+      processes.push_back(snapshot.pids[i]);
+    }
+#endif
+
+    return processes;
+  }
+
+  void ProcessSnapshot::clear() {
+    pids.clear();
+    ppids.clear();
+    states.clear();
+    rss.clear();
+    utime.clear();
+    stime.clear();
+    start_time.clear();
+  }
+
+  size_t ProcessSnapshot::FindIndex(const processid_t & pid) const {
+    //process ids are sorted
+    ProcessIdList::const_iterator it = std::lower_bound(pids.begin(), pids.end(), pid);
+    if (it == pids.end() || *it != pid)
+      return ra::generics::INVALID_INDEX;
+    size_t index = (size_t)(it - pids.begin());
+    return index;
+  }
+
+  template <typename T> inline void ApplyPermutation(std::vector<T> & values, const std::vector<size_t> & permutation) {
+    std::vector<T> sorted(values.size());
+    for (size_t i = 0; i < permutation.size(); i++) {
+      sorted[i] = values[permutation[i]];
+    }
+    values.swap(sorted);
+  }
+
+  struct PidIndexLess {
+    const ProcessIdList * pids;
+    bool operator()(size_t a, size_t b) const { return (*pids)[a] < (*pids)[b]; }
+  };
+
+  /// <summary>
+  /// Sort all the lists of a snapshot by process id.
+  /// </summary>
+  void SortProcessSnapshot(ProcessSnapshot & snapshot) {
+    std::vector<size_t> permutation(snapshot.size());
+    for (size_t i = 0; i < permutation.size(); i++) {
+      permutation[i] = i;
+    }
+    PidIndexLess less;
+    less.pids = &snapshot.pids;
+    std::sort(permutation.begin(), permutation.end(), less);
+
+    ApplyPermutation(snapshot.pids, permutation);
+    ApplyPermutation(snapshot.ppids, permutation);
+    ApplyPermutation(snapshot.states, permutation);
+    ApplyPermutation(snapshot.rss, permutation);
+    ApplyPermutation(snapshot.utime, permutation);
+    ApplyPermutation(snapshot.stime, permutation);
+    ApplyPermutation(snapshot.start_time, permutation);
+  }
+
+  bool GetProcessSnapshot(ProcessSnapshot & snapshot) {
+    snapshot.clear();
+
+#ifdef _WIN32
+    snapshot.ticks_per_second = 1;
+
+    HANDLE hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hProcessSnap == INVALID_HANDLE_VALUE)
+      return false;
+
+    PROCESSENTRY32 process_entry;
+    process_entry.dwSize = sizeof(PROCESSENTRY32);
+    if (!Process32First(hProcessSnap, &process_entry)) {
+      CloseHandle(hProcessSnap);
+      return false;
+    }
+
+    do {
+      snapshot.pids.push_back(process_entry.th32ProcessID);
+      snapshot.ppids.push_back(process_entry.th32ParentProcessID);
+      snapshot.states.push_back('R');
+      snapshot.rss.push_back(0);
+      snapshot.utime.push_back(0);
+      snapshot.stime.push_back(0);
+      snapshot.start_time.push_back(0);
+    } while (Process32Next(hProcessSnap, &process_entry));
+
+    CloseHandle(hProcessSnap);
+#else
+    static const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+    static const uint64_t ticks_per_second = (uint64_t)sysconf(_SC_CLK_TCK);
+    snapshot.ticks_per_second = ticks_per_second;
+
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0)
+      return false;
+
+    //read the directory entries in large batches
+    uint64_t buffer[4096];
+    long length = 0;
+    while ((length = syscall(SYS_getdents64, proc_fd, buffer, sizeof(buffer))) > 0) {
+      const char * entries = (const char *)buffer;
+      for (long offset = 0; offset < length; ) {
+        const LinuxDirent64 * entry = (const LinuxDirent64 *)(entries + offset);
+        offset += entry->d_reclen;
+
+        //filter out files
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+          continue;
+
+        //filter out directories that are not numeric.
+        //that's a process id. Parse it
+        const char * name = entry->d_name;
+        processid_t pid = 0;
+        bool numeric = (*name != '\0');
+        for (const char * c = name; *c != '\0' && numeric; c++) {
+          if (*c < '0' || *c > '9')
+            numeric = false;
+          else
+            pid = pid * 10 + (*c - '0');
+        }
+        if (!numeric)
+          continue;
+
+        //read /proc/[pid]/stat
+        char stat_path[64];
+        size_t name_length = strlen(name);
+        if (name_length + sizeof("/stat") > sizeof(stat_path))
+          continue;
+        memcpy(stat_path, name, name_length);
+        memcpy(stat_path + name_length, "/stat", sizeof("/stat"));
+
+        ProcessStat stat;
+        if (!ReadProcessStat(proc_fd, stat_path, stat))
+          continue; //the process has exited
+
+        snapshot.pids.push_back(pid);
+        snapshot.ppids.push_back(stat.ppid);
+        snapshot.states.push_back(stat.state);
+        snapshot.rss.push_back(stat.rss_pages * page_size);
+        snapshot.utime.push_back(stat.utime);
+        snapshot.stime.push_back(stat.stime);
+        snapshot.start_time.push_back(stat.start_time);
+      }
+    }
+    close(proc_fd);
+
+    if (length < 0)
+      return false;
+#endif
+
+    //the kernel lists process ids in ascending order but this is not guaranteed on all platforms
+    bool sorted = true;
+    for (size_t i = 1; i < snapshot.pids.size() && sorted; i++) {
+      if (snapshot.pids[i - 1] > snapshot.pids[i])
+        sorted = false;
+    }
+    if (!sorted)
+      SortProcessSnapshot(snapshot);
+
+    return true;
+  }
+
+  processid_t GetCurrentProcessId() {
+#ifdef _WIN32
+    processid_t pid = ::GetCurrentProcessId();
+#else
+    processid_t pid = getpid();
+#endif
+    return pid;
+  }
+
+  std::string GetCurrentProcessDir() {
+    std::string dir;
+    std::string exec_path = GetCurrentProcessPath();
+    if (exec_path.empty())
+      return dir; //failure
+    dir = ra::filesystem::GetParentPath(exec_path);
+    return dir;
+  }
+
+  processid_t StartProcess(const std::string & iExecPath) {
+    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    // Launch the process from the current process current directory
+    processid_t pid = StartProcess(iExecPath, curr_dir);
+    return pid;
+  }
+
+  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory) {
+    // Launch the process with no arguments
+#ifdef _WIN32
+    processid_t pid = StartProcess(iExecPath, iDefaultDirectory, "");
+    return pid;
+#else
+    ra::strings::StringVector args;
+    processid_t pid = StartProcess(iExecPath, iDefaultDirectory, args);
+    return pid;
+#endif
+  }
+
+#ifdef _WIN32
+  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory, const std::string & iCommandLine) {
+    //build the full command line
+    std::string command;
+
+    //handle iExecPath
+    if (!iExecPath.empty()) {
+      if (iExecPath.find(" ") != std::string::npos) {
+        command += "\"";
+        command += iExecPath;
+        command += "\"";
+      }
+      else
+        command += iExecPath;
+    }
+
+    if (!command.empty()) {
+      command += " ";
+      command += iCommandLine;
+    }
+
+    //launch a new process with the command line
+    PROCESS_INFORMATION process_info = { 0 };
+    STARTUPINFO startup_info = { 0 };
+    startup_info.cb = sizeof(STARTUPINFO);
+    startup_info.dwFlags = STARTF_USESHOWWINDOW;
+    startup_info.wShowWindow = SW_SHOWDEFAULT; //SW_SHOW, SW_SHOWNORMAL
+    static const DWORD creation_flags = 0; //EXTENDED_STARTUPINFO_PRESENT
+    bool success = (CreateProcess(NULL, (char*)command.c_str(), NULL, NULL, FALSE, creation_flags, NULL, iDefaultDirectory.c_str(), &startup_info, &process_info) != 0);
+    if (success) {
+      //Wait for the application to initialize properly
+      WaitForInputIdle(process_info.hProcess, INFINITE);
+
+      //Extract the program id
+      DWORD process_id = process_info.dwProcessId;
+
+      //return the process id
+      processid_t pId = static_cast<processid_t>(process_id);
+      return pId;
+    }
+    return INVALID_PROCESS_ID;
+  }
+#else
+  processid_t StartProcess(const std::string & iExecPath, const std::string & iDefaultDirectory, const ra::strings::StringVector & iArguments) {
+    //temporary change the current directory for the child process
+    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    if (!ra::filesystem::DirectoryExists(iDefaultDirectory.c_str()))
+      return INVALID_PROCESS_ID;
+    int chdir_result = chdir(iDefaultDirectory.c_str());
+
+    //prepare argv
+    //the first element of argv must be the executable path itself.
+    //the last element of argv must be am empty argument
+    static const int MAX_ARGUMENTS = 10240;
+    char * argv[MAX_ARGUMENTS] = { 0 };
+    argv[0] = (char*)iExecPath.c_str();
+    for (size_t i = 0; i < iArguments.size() && i < (MAX_ARGUMENTS - 2); i++) {
+      char * arg_value = (char*)iArguments[i].c_str();
+      argv[i + 1] = arg_value;
+    }
+
+    //Print arguments.
+    //printf("posix_spawn():\n");
+    //fflush(NULL);
+    //int i=0;
+    //while(argv[i])
+    //{
+    //  printf("arg[%d]=%s\n", i, argv[i]);
+    //  i++;
+    //}
+
+    pid_t child_pid = INVALID_PROCESS_ID;
+    int status = posix_spawn(&child_pid, iExecPath.c_str(), NULL, NULL, argv, environ);
+    if (status != 0)
+      child_pid = INVALID_PROCESS_ID;
+
+    //restore current directory back to the previous location
+    chdir_result = chdir(curr_dir.c_str());
+
+    return child_pid;
+  }
+#endif
+
+  bool OpenDocument(const std::string & iPath) {
+    if (!ra::filesystem::FileExists(iPath.c_str()))
+      return false; //file not found
+
+#ifdef _WIN32
+    SHELLEXECUTEINFO info = { 0 };
+
+    info.cbSize = sizeof(SHELLEXECUTEINFO);
+
+    info.fMask |= SEE_MASK_NOCLOSEPROCESS;
+    info.fMask |= SEE_MASK_NOASYNC;
+    info.fMask |= SEE_MASK_FLAG_DDEWAIT;
+
+    info.hwnd = HWND_DESKTOP;
+    info.nShow = SW_SHOWDEFAULT;
+    info.lpVerb = "open";
+    info.lpFile = iPath.c_str();
+    info.lpParameters = NULL; //arguments
+    info.lpDirectory = NULL; // default directory
+
+    BOOL success = ShellExecuteEx(&info);
+    if (success) {
+      HANDLE hProcess = info.hProcess;
+      DWORD pid = GetProcessId(hProcess);
+      return true;
+    }
+    return false;
+#else
+    const char * xdgopen_path = "/usr/bin/xdg-open";
+    if (!ra::filesystem::FileExists(xdgopen_path))
+      return false; //xdg-open not found
+
+    const ra::strings::StringVector args;
+    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    processid_t pid = StartProcess(xdgopen_path, curr_dir, args);
+    bool success = (pid != INVALID_PROCESS_ID);
+    return success;
+#endif
+  }
+
+  bool Kill(const processid_t & pid) {
+    bool success = false;
+#ifdef _WIN32
+    //Get a handle
+    HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
+    if (hProcess) {
+      success = (TerminateProcess(hProcess, 255) != 0);
+      CloseHandle(hProcess);
+    }
+#else
+    int kill_error = ::kill(pid, SIGKILL);
+    success = (kill_error == 0);
+
+    if (success) {
+      // call waitpid() on Linux to prevent having zombie processes.
+      int status = 0;
+      processid_t result_pid = waitpid(pid, &status, 0);
+    }
+
+#endif
+    return success;
+  }
+
+  bool IsRunning(const processid_t & pid) {
+#ifdef _WIN32
+    DWORD exit_code = 0;
+    ExitCodeResult result = GetWin32ExitCodeResult(pid, exit_code);
+    bool running = false;
+    switch (result) {
+    case EXIT_CODE_SUCCESS:
+      running = false;
+      break;
+    case EXIT_CODE_STILLRUNNING:
+      running = true;
+      break;
+    case EXIT_CODE_FAILED:
+    {
+      //set the process as not running by default
+      running = false;
+
+      //search within existing processes
+      ProcessIdList processes = GetProcesses();
+      for (size_t i = 0; i < processes.size() && running == false; i++) {
+        DWORD tmp_pid = processes[i];
+        if (tmp_pid == pid)
+          running = true;
+      }
+    }
+    break;
+    default:
+      running = false; //should not append unless GetWin32ExitCodeResult is modified without notice.
+    };
+    return running;
+#else
+    char state = '\0';
+    if (!GetProcessState(pid, state))
+      return false; //unable to find process state
+
+    // See GetProcessState() for known process states.
+    bool running = IsRunningState(state);
+    return running;
+#endif
+  }
+
+  bool Terminate(const processid_t & pid) {
+#ifdef _WIN32
+    //ask the process to exit gracefully allowing a maximum of 60 seconds to close
+    bool terminated = Terminate(pid, 60000);
+    return terminated;
+#else
+    //ask the process to exit gracefully
+    int kill_error = ::kill(pid, SIGTERM);
+    bool success = (kill_error == 0);
+
+    if (success) {
+      // call waitpid() on Linux to prevent having zombie processes.
+      int status = 0;
+      processid_t result_pid = waitpid(pid, &status, 0);
+    }
+
+    return success;
+#endif
+  }
+
+  bool GetProcessTree(const processid_t & pid, ProcessIdList & tree) {
+    tree.clear();
+
+    ProcessSnapshot snapshot;
+    if (!GetProcessSnapshot(snapshot))
+      return false;
+    if (snapshot.FindIndex(pid) == ra::generics::INVALID_INDEX)
+      return false;
+
+    //breadth first search of the descendants using the parent process ids
+    tree.push_back(pid);
+    for (size_t i = 0; i < tree.size(); i++) {
+      const processid_t & parent = tree[i];
+      for (size_t j = 0; j < snapshot.size(); j++) {
+        if (snapshot.ppids[j] == parent && snapshot.pids[j] != parent)
+          tree.push_back(snapshot.pids[j]);
+      }
+    }
+
+    return true;
+  }
+
+  TerminateResult TerminateAsync(const processid_t & pid, uint32_t grace_period) {
+    ProcessIdList pids;
+    pids.push_back(pid);
+    TerminateResultList results;
+    TerminateAsync(pids, grace_period, results);
+    return results[0];
+  }
+
+  bool TerminateAsync(const ProcessIdList & pids, uint32_t grace_period, TerminateResultList & results) {
+    results.assign(pids.size(), TERMINATE_FAILED);
+    const double deadline = ra::timing::GetMicrosecondsTimer() + grace_period / 1000.0;
+
+#ifdef _WIN32
+    //WIN32 does not allow waiting for the close messages of multiple processes at once.
+    //Split the remaining grace period between the remaining processes.
+    bool success = true;
+    for (size_t i = 0; i < pids.size(); i++) {
+      const processid_t & pid = pids[i];
+      double remaining = (deadline - ra::timing::GetMicrosecondsTimer()) * 1000.0;
+      DWORD timeout = (remaining > 0.0 ? (DWORD)(remaining / (pids.size() - i)) : 0);
+      if (timeout > 0 && Terminate(pid, timeout))
+        results[i] = TERMINATE_EXITED;
+      else if (!IsRunning(pid))
+        results[i] = TERMINATE_EXITED;
+      else if (Kill(pid))
+        results[i] = TERMINATE_KILLED;
+      else
+        success = false;
+    }
+    return success;
+#else
+    //open a pidfd before sending the signal. This prevents waiting for another process if the process id is reused.
+    std::vector<int> pidfds(pids.size(), -1);
+    std::vector<bool> pending(pids.size(), false);
+    size_t num_pending = 0;
+    bool success = true;
+    for (size_t i = 0; i < pids.size(); i++) {
+#ifdef SYS_pidfd_open
+      pidfds[i] = (int)syscall(SYS_pidfd_open, pids[i], 0);
+#endif
+      if (::kill(pids[i], SIGTERM) == 0) {
+        pending[i] = true;
+        num_pending++;
+      }
+      else {
+        success = false;
+      }
+    }
+
+    //wait for the processes to exit until the deadline
+    std::vector<struct pollfd> fds;
+    std::vector<size_t> fds_indexes;
+    while (num_pending > 0) {
+      double remaining = (deadline - ra::timing::GetMicrosecondsTimer()) * 1000.0;
+      if (remaining <= 0.0)
+        break;
+
+      //processes without a pidfd must be polled
+      bool polling = false;
+      fds.clear();
+      fds_indexes.clear();
+      for (size_t i = 0; i < pids.size(); i++) {
+        if (!pending[i])
+          continue;
+        if (pidfds[i] == -1) {
+          polling = true;
+          continue;
+        }
+        struct pollfd pfd;
+        pfd.fd = pidfds[i];
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        fds.push_back(pfd);
+        fds_indexes.push_back(i);
+      }
+
+      int timeout = (int)remaining + 1;
+      if (polling && timeout > 10)
+        timeout = 10;
+      int num_events = poll(fds.empty() ? NULL : &fds[0], (nfds_t)fds.size(), timeout);
+      if (num_events < 0 && errno != EINTR)
+        break;
+
+      for (size_t i = 0; i < fds.size(); i++) {
+        if (fds[i].revents != 0) {
+          size_t index = fds_indexes[i];
+          pending[index] = false;
+          results[index] = TERMINATE_EXITED;
+          num_pending--;
+        }
+      }
+      if (polling) {
+        for (size_t i = 0; i < pids.size(); i++) {
+          if (pending[i] && pidfds[i] == -1 && !IsRunning(pids[i])) {
+            pending[i] = false;
+            results[i] = TERMINATE_EXITED;
+            num_pending--;
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < pids.size(); i++) {
+      if (pending[i]) {
+        //the grace period has elapsed. Do not wait for the process to die.
+        if (::kill(pids[i], SIGKILL) == 0)
+          results[i] = TERMINATE_KILLED;
+        else if (!IsRunning(pids[i]))
+          results[i] = TERMINATE_EXITED;
+        else
+          success = false;
+      }
+      if (results[i] == TERMINATE_EXITED) {
+        //call waitpid() on Linux to prevent having zombie processes.
+        int status = 0;
+        waitpid(pids[i], &status, WNOHANG);
+      }
+      if (pidfds[i] != -1)
+        close(pidfds[i]);
+    }
+
+    return success;
+#endif
+  }
+
+  bool TerminateTree(const processid_t & pid, uint32_t grace_period, ProcessIdList & pids, TerminateResultList & results) {
+    results.clear();
+    if (!GetProcessTree(pid, pids))
+      return false;
+
+    //signal the descendants before their parents
+    std::reverse(pids.begin(), pids.end());
+    bool success = TerminateAsync(pids, grace_period, results);
+    return success;
+  }
+
+  bool GetExitCode(const processid_t & pid, int & exit_code) {
+#ifdef _WIN32
+    DWORD local_exit_code;
+    ExitCodeResult result = GetWin32ExitCodeResult(pid, local_exit_code);
+    if (result == EXIT_CODE_SUCCESS) {
+      exit_code = static_cast<int>(local_exit_code);
+      return true;
+    }
+    return false;
+#else
+    int status = 0;
+    if (waitpid(pid, &status, WNOHANG | WUNTRACED | WCONTINUED) == pid) {
+      //waitpid success
+      bool process_exited = WIFEXITED(status);
+      exit_code = WEXITSTATUS(status);
+      return true;
+    }
+    return false;
+#endif
+  }
+
+  bool WaitExit(const processid_t & pid) {
+#ifdef _WIN32
+    //Get a handle on the process
+    HANDLE hProcess = OpenProcess(SYNCHRONIZE, TRUE, pid);
+    if (hProcess) {
+      //now wait for the process termination
+      WaitForSingleObject(hProcess, INFINITE);
+
+      CloseHandle(hProcess);
+      return true;
+    }
+    return false;
+#else
+    //DISABLED THE FOLLOWING IMPLEMENTATION:
+    //  waitpid() function consumes the process exit code which disables the implementation of GetExitCode().
+    //  In other words, calling GetExitCode() will always fails after calling the waitpid() function.
+    //  This is why this function would have to also return the exit code.
+    //  
+    //  int status = 0;
+    //  if (waitpid(pid, &status, 0) == pid)
+    //  {
+    //    //waitpid success
+    //    bool process_exited = WIFEXITED( status );
+    //    int exit_code = WEXITSTATUS( status );
+    //    return true;
+    //  }
+    //  return false;
+
+    //DISABLED THE FOLLOWING IMPLEMENTATION:
+    //  Using kill() function to detect if a process is alive works great but it does not detect
+    //  when a process is done executing and enters zombie state waiting for the user to call waitpid()
+    //  to get the process exit code.
+    //
+    //  int res = ::kill(pid, 0);
+    //  while (res == 0 || (res < 0 && errno == EPERM))
+    //  {
+    //    ra::timing::Millisleep(100);
+    //    res = ::kill(pid, 0);
+    //  }
+
+    //validate if pid is valid
+    int res = ::kill(pid, 0);
+    bool valid_pid = (res == 0 || (res < 0 && errno == EPERM));
+    if (!valid_pid)
+      return false;
+
+    //wait for the process state to change
+    //this implementation is slow but does not rely on waitpid()
+    //to detect the end of the process
+    while (IsRunning(pid)) {
+      //wait a little more and verify again
+      ra::timing::Millisleep(1000);
+    }
+
+    return true;
+#endif
+  }
+
+  bool WaitExit(const processid_t & pid, int & exit_code) {
+    bool success = WaitExit(pid);
+    if (!success)
+      return false;
+
+#ifndef _WIN32
+    //also read the process exit code to remove the zombie process
+    success = GetExitCode(pid, exit_code);
+#endif
+
+    return success;
+  }
+
+} //namespace process
+} //namespace ra
@@ -0,0 +1,359 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/processwatcher.h"
+#include "rapidassist/generics.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#endif
+
+namespace ra { namespace process {
+
+  void ProcessDelta::clear() {
+    started.clear();
+    exited.clear();
+    executed.clear();
+    changed.clear();
+  }
+
+  bool ProcessDelta::empty() const {
+    return started.empty() && exited.empty() && executed.empty() && changed.empty();
+  }
+
+  /// <summary>
+  /// Swap the content of two snapshots without copying their buffers.
+  /// </summary>
+  void SwapSnapshots(ProcessSnapshot & a, ProcessSnapshot & b) {
+    a.pids.swap(b.pids);
+    a.ppids.swap(b.ppids);
+    a.states.swap(b.states);
+    a.rss.swap(b.rss);
+    a.utime.swap(b.utime);
+    a.stime.swap(b.stime);
+    a.start_time.swap(b.start_time);
+    std::swap(a.ticks_per_second, b.ticks_per_second);
+  }
+
+  /// <summary>
+  /// Insert a new process in a snapshot keeping the process ids sorted.
+  /// The resource usage values of the new process are unknown and set to 0.
+  /// </summary>
+  bool InsertProcess(ProcessSnapshot & snapshot, const processid_t & pid, const processid_t & ppid) {
+    ProcessIdList::iterator it = std::lower_bound(snapshot.pids.begin(), snapshot.pids.end(), pid);
+    if (it != snapshot.pids.end() && *it == pid)
+      return false; //already known
+    size_t index = (size_t)(it - snapshot.pids.begin());
+    snapshot.pids.insert(it, pid);
+    snapshot.ppids.insert(snapshot.ppids.begin() + index, ppid);
+    snapshot.states.insert(snapshot.states.begin() + index, 'R');
+    snapshot.rss.insert(snapshot.rss.begin() + index, 0);
+    snapshot.utime.insert(snapshot.utime.begin() + index, 0);
+    snapshot.stime.insert(snapshot.stime.begin() + index, 0);
+    snapshot.start_time.insert(snapshot.start_time.begin() + index, 0);
+    return true;
+  }
+
+  /// <summary>
+  /// Remove a process from a snapshot.
+  /// </summary>
+  bool RemoveProcess(ProcessSnapshot & snapshot, const processid_t & pid) {
+    size_t index = snapshot.FindIndex(pid);
+    if (index == ra::generics::INVALID_INDEX)
+      return false; //unknown process
+    snapshot.pids.erase(snapshot.pids.begin() + index);
+    snapshot.ppids.erase(snapshot.ppids.begin() + index);
+    snapshot.states.erase(snapshot.states.begin() + index);
+    snapshot.rss.erase(snapshot.rss.begin() + index);
+    snapshot.utime.erase(snapshot.utime.begin() + index);
+    snapshot.stime.erase(snapshot.stime.begin() + index);
+    snapshot.start_time.erase(snapshot.start_time.begin() + index);
+    return true;
+  }
+
+  ProcessWatcher::ProcessWatcher() :
+    started_(false),
+    events_fd_(-1) {
+  }
+
+  ProcessWatcher::~ProcessWatcher() {
+    Stop();
+  }
+
+  bool ProcessWatcher::Start(bool prefer_events) {
+    if (started_)
+      return true;
+
+    //subscribe to the events before taking the initial snapshot to not miss any process
+    if (prefer_events)
+      OpenEvents();
+
+    if (!GetProcessSnapshot(current_)) {
+      CloseEvents();
+      return false;
+    }
+
+    started_ = true;
+    return true;
+  }
+
+  bool ProcessWatcher::Stop() {
+    CloseEvents();
+    current_.clear();
+    next_.clear();
+    started_ = false;
+    return true;
+  }
+
+  bool ProcessWatcher::IsStarted() const {
+    return started_;
+  }
+
+  bool ProcessWatcher::IsEventDriven() const {
+    return (events_fd_ != -1);
+  }
+
+  const ProcessSnapshot & ProcessWatcher::GetSnapshot() const {
+    return current_;
+  }
+
+  bool ProcessWatcher::Poll(ProcessDelta & delta) {
+    delta.clear();
+    if (!started_)
+      return false;
+
+    if (IsEventDriven())
+      return PollEvents(delta);
+    return PollSnapshot(delta);
+  }
+
+  bool ProcessWatcher::PollSnapshot(ProcessDelta & delta) {
+    if (!GetProcessSnapshot(next_))
+      return false;
+
+    //both snapshots are sorted by process id. Merge them in a single pass.
+    const ProcessSnapshot & prev = current_;
+    const ProcessSnapshot & curr = next_;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < prev.size() || j < curr.size()) {
+      if (j >= curr.size() || (i < prev.size() && prev.pids[i] < curr.pids[j])) {
+        delta.exited.push_back(prev.pids[i]);
+        i++;
+      }
+      else if (i >= prev.size() || curr.pids[j] < prev.pids[i]) {
+        delta.started.push_back(curr.pids[j]);
+        j++;
+      }
+      else {
+        const processid_t & pid = curr.pids[j];
+        if (prev.start_time[i] != curr.start_time[j]) {
+          //the process id was reused by a new process
+          delta.exited.push_back(pid);
+          delta.started.push_back(pid);
+        }
+        else if (prev.utime[i] != curr.utime[j] ||
+                 prev.stime[i] != curr.stime[j] ||
+                 prev.rss[i] != curr.rss[j]) {
+          delta.changed.push_back(pid);
+        }
+        i++;
+        j++;
+      }
+    }
+
+    SwapSnapshots(current_, next_);
+    return true;
+  }
+
+#ifdef __linux__
+  /// <summary>
+  /// Send a subscription request to the kernel proc connector.
+  /// </summary>
+  bool SendProcConnectorRequest(int fd, enum proc_cn_mcast_op op) {
+    uint64_t buffer[(NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op)) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    memset(buffer, 0, sizeof(buffer));
+
+    struct nlmsghdr * header = (struct nlmsghdr *)buffer;
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = getpid();
+
+    struct cn_msg * msg = (struct cn_msg *)NLMSG_DATA(header);
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(enum proc_cn_mcast_op);
+    memcpy(msg->data, &op, sizeof(op));
+
+    ssize_t sent = send(fd, header, header->nlmsg_len, 0);
+    return (sent == (ssize_t)header->nlmsg_len);
+  }
+#endif
+
+  bool ProcessWatcher::OpenEvents() {
+#ifdef __linux__
+    int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+    if (fd < 0)
+      return false;
+
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0;
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        !SendProcConnectorRequest(fd, PROC_CN_MCAST_LISTEN)) {
+      close(fd);
+      return false;
+    }
+
+    //wait for the kernel to acknowledge the subscription
+    bool acknowledged = false;
+    while (!acknowledged) {
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll(&pfd, 1, 1000) <= 0)
+        break; //no acknowledge received
+
+      uint64_t buffer[1024];
+      ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+      if (length <= 0)
+        break;
+      const struct nlmsghdr * header = (const struct nlmsghdr *)buffer;
+      for (; NLMSG_OK(header, (size_t)length); header = NLMSG_NEXT(header, length)) {
+        const struct cn_msg * msg = (const struct cn_msg *)NLMSG_DATA(header);
+        const struct proc_event * event = (const struct proc_event *)msg->data;
+        if (msg->id.idx == CN_IDX_PROC && event->what == proc_event::PROC_EVENT_NONE) {
+          if (event->event_data.ack.err != 0) {
+            close(fd);
+            return false; //subscription denied
+          }
+          acknowledged = true;
+        }
+      }
+    }
+    if (!acknowledged) {
+      close(fd);
+      return false;
+    }
+
+    events_fd_ = fd;
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void ProcessWatcher::CloseEvents() {
+#ifdef __linux__
+    if (events_fd_ == -1)
+      return;
+    SendProcConnectorRequest(events_fd_, PROC_CN_MCAST_IGNORE);
+    close(events_fd_);
+    events_fd_ = -1;
+#endif
+  }
+
+  bool ProcessWatcher::PollEvents(ProcessDelta & delta) {
+#ifdef __linux__
+    bool overflow = false;
+    uint64_t buffer[1024];
+    while (true) {
+      ssize_t length = recv(events_fd_, buffer, sizeof(buffer), 0);
+      if (length < 0) {
+        if (errno == EINTR)
+          continue;
+        if (errno == ENOBUFS) {
+          //some events were dropped by the kernel
+          overflow = true;
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          break; //no more pending events
+        return false;
+      }
+
+      const struct nlmsghdr * header = (const struct nlmsghdr *)buffer;
+      for (; NLMSG_OK(header, (size_t)length); header = NLMSG_NEXT(header, length)) {
+        if (header->nlmsg_type == NLMSG_NOOP || header->nlmsg_type == NLMSG_ERROR)
+          continue;
+        const struct cn_msg * msg = (const struct cn_msg *)NLMSG_DATA(header);
+        if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC)
+          continue;
+        const struct proc_event * event = (const struct proc_event *)msg->data;
+
+        //ignore threads events
+        switch (event->what) {
+        case proc_event::PROC_EVENT_FORK:
+          if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+            processid_t pid = event->event_data.fork.child_tgid;
+            if (InsertProcess(current_, pid, event->event_data.fork.parent_tgid))
+              delta.started.push_back(pid);
+          }
+          break;
+        case proc_event::PROC_EVENT_EXEC:
+          if (event->event_data.exec.process_pid == event->event_data.exec.process_tgid)
+            delta.executed.push_back(event->event_data.exec.process_tgid);
+          break;
+        case proc_event::PROC_EVENT_EXIT:
+          if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+            processid_t pid = event->event_data.exit.process_tgid;
+            if (RemoveProcess(current_, pid))
+              delta.exited.push_back(pid);
+          }
+          break;
+        default:
+          break;
+        };
+      }
+    }
+
+    //resynchronize with the process table if events were lost
+    if (overflow) {
+      ProcessDelta resync;
+      if (!PollSnapshot(resync))
+        return false;
+      delta.started.insert(delta.started.end(), resync.started.begin(), resync.started.end());
+      delta.exited.insert(delta.exited.end(), resync.exited.begin(), resync.exited.end());
+    }
+
+    return true;
+#else
+    return false;
+#endif
+  }
+
+} //namespace process
+} //namespace ra
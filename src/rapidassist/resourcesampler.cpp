@@ -0,0 +1,428 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/resourcesampler.h"
+#include "rapidassist/strings.h"
+#include "rapidassist/timing.h"
+
+#include <algorithm>
+#include <string.h> //for memset()
+
+#ifdef _WIN32
+#   ifndef WIN32_LEAN_AND_MEAN
+#   define WIN32_LEAN_AND_MEAN 1
+#   endif
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <stdio.h>
+#   include <stdlib.h>
+#endif
+
+namespace ra { namespace process {
+
+#ifdef _WIN32
+  inline double ToSeconds(const FILETIME & time) {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return (double)value.QuadPart / 10000000.0; //FILETIME is in 100 nanoseconds units
+  }
+
+  bool GetResourceSample(const processid_t & pid, ResourceSample & sample) {
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = ra::timing::GetMicrosecondsTimer();
+
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+    if (hProcess == NULL)
+      return false;
+
+    bool success = false;
+    DWORD exit_code = 0;
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (GetExitCodeProcess(hProcess, &exit_code) && exit_code == STILL_ACTIVE &&
+        GetProcessTimes(hProcess, &creation_time, &exit_time, &kernel_time, &user_time)) {
+      sample.user_time = ToSeconds(user_time);
+      sample.system_time = ToSeconds(kernel_time);
+
+      PROCESS_MEMORY_COUNTERS counters;
+      if (GetProcessMemoryInfo(hProcess, &counters, sizeof(counters))) {
+        sample.rss = counters.WorkingSetSize;
+        sample.virtual_size = counters.PagefileUsage;
+      }
+
+      IO_COUNTERS io;
+      if (GetProcessIoCounters(hProcess, &io)) {
+        sample.read_bytes = io.ReadTransferCount;
+        sample.write_bytes = io.WriteTransferCount;
+      }
+      success = true;
+    }
+
+    CloseHandle(hProcess);
+    return success;
+  }
+#else
+  /// <summary>
+  /// Read a small /proc file in a buffer. The buffer is always NULL terminated.
+  /// </summary>
+  /// <returns>Returns the number of bytes read. Returns -1 on error.</returns>
+  ssize_t ReadProcFile(const char * path, char * buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return -1;
+    ssize_t length = read(fd, buffer, size - 1);
+    close(fd);
+    if (length < 0)
+      return -1;
+    buffer[length] = '\0';
+    return length;
+  }
+
+  /// <summary>
+  /// Find the value of a "name: value" line in the content of /proc/[pid]/io.
+  /// </summary>
+  uint64_t FindIoCounter(const char * content, const char * name) {
+    const char * position = strstr(content, name);
+    if (position == NULL)
+      return 0;
+    return strtoull(position + strlen(name), NULL, 10);
+  }
+
+  bool GetResourceSample(const processid_t & pid, ResourceSample & sample) {
+    static const double ticks_per_second = (double)sysconf(_SC_CLK_TCK);
+    static const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = ra::timing::GetMicrosecondsTimer();
+
+    char path[64];
+    char buffer[1024];
+
+    //read /proc/[pid]/stat for cpu times.
+    //The name of the process (field 2) may contain spaces or parenthesis. Fields are parsed from the last ')'.
+    sprintf(path, "/proc/%d/stat", (int)pid);
+    if (ReadProcFile(path, buffer, sizeof(buffer)) <= 0)
+      return false;
+    const char * position = strrchr(buffer, ')');
+    if (position == NULL || position[1] == '\0' || position[2] == '\0')
+      return false;
+    char state = position[2];
+    if (state == 'Z' || state == 'X')
+      return false; //the process has terminated
+    position += 3;
+    //skip fields 4 to 13 to reach utime (field 14) and stime (field 15)
+    for (int i = 4; i < 14 && position != NULL; i++) {
+      position = strchr(position + 1, ' ');
+    }
+    if (position == NULL)
+      return false;
+    char * end = NULL;
+    uint64_t utime = strtoull(position, &end, 10);
+    uint64_t stime = strtoull(end, NULL, 10);
+    sample.user_time = (double)utime / ticks_per_second;
+    sample.system_time = (double)stime / ticks_per_second;
+
+    //read /proc/[pid]/statm for memory usage
+    sprintf(path, "/proc/%d/statm", (int)pid);
+    if (ReadProcFile(path, buffer, sizeof(buffer)) > 0) {
+      uint64_t size = strtoull(buffer, &end, 10);
+      uint64_t resident = strtoull(end, NULL, 10);
+      sample.virtual_size = size * page_size;
+      sample.rss = resident * page_size;
+    }
+
+    //read /proc/[pid]/io for storage usage. Not readable for processes of other users.
+    sprintf(path, "/proc/%d/io", (int)pid);
+    if (ReadProcFile(path, buffer, sizeof(buffer)) > 0) {
+      sample.read_bytes = FindIoCounter(buffer, "\nread_bytes:");
+      sample.write_bytes = FindIoCounter(buffer, "\nwrite_bytes:");
+    }
+
+    return true;
+  }
+#endif
+
+  /// <summary>
+  /// Computes the statistics of the given values. The values are sorted by the function.
+  /// Percentiles are computed with the nearest-rank method.
+  /// </summary>
+  void ComputeStatistics(std::vector<double> & values, ResourceStatistics & stats) {
+    memset(&stats, 0, sizeof(stats));
+    if (values.empty())
+      return;
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < values.size(); i++) {
+      sum += values[i];
+    }
+
+    const size_t count = values.size();
+    stats.min = values[0];
+    stats.max = values[count - 1];
+    stats.avg = sum / count;
+    stats.p50 = values[(count * 50 + 99) / 100 - 1];
+    stats.p90 = values[(count * 90 + 99) / 100 - 1];
+    stats.p99 = values[(count * 99 + 99) / 100 - 1];
+  }
+
+  bool IsHigherCpuTime(const ResourceSummary & a, const ResourceSummary & b) {
+    return a.cpu_time > b.cpu_time;
+  }
+
+  ResourceSampler::ResourceSampler(size_t capacity) :
+    capacity_(capacity == 0 ? 1 : capacity),
+    interval_(1000),
+    last_sample_time_(0.0) {
+  }
+
+  ResourceSampler::~ResourceSampler() {
+  }
+
+  bool ResourceSampler::AddProcess(const processid_t & pid) {
+    if (histories_.find(pid) != histories_.end())
+      return false;
+    History & history = histories_[pid];
+    history.samples.resize(capacity_);
+    history.first = 0;
+    history.count = 0;
+    history.total = 0;
+    history.running = true;
+    return true;
+  }
+
+  bool ResourceSampler::RemoveProcess(const processid_t & pid) {
+    return (histories_.erase(pid) > 0);
+  }
+
+  ProcessIdList ResourceSampler::GetProcesses() const {
+    ProcessIdList processes;
+    for (HistoryMap::const_iterator it = histories_.begin(); it != histories_.end(); it++) {
+      processes.push_back(it->first);
+    }
+    return processes;
+  }
+
+  void ResourceSampler::SetInterval(uint32_t milliseconds) {
+    interval_ = milliseconds;
+  }
+
+  uint32_t ResourceSampler::GetInterval() const {
+    return interval_;
+  }
+
+  size_t ResourceSampler::Sample() {
+    size_t num_running = 0;
+    for (HistoryMap::iterator it = histories_.begin(); it != histories_.end(); it++) {
+      History & history = it->second;
+      if (!history.running)
+        continue;
+
+      ResourceSample sample;
+      if (!GetResourceSample(it->first, sample)) {
+        history.running = false;
+        continue;
+      }
+      num_running++;
+
+      //compute the cpu usage since the previous sample
+      sample.cpu_usage = 0.0;
+      if (history.count > 0) {
+        const ResourceSample & previous = history.samples[(history.first + history.count - 1) % capacity_];
+        double elapsed = sample.timestamp - previous.timestamp;
+        double cpu_elapsed = (sample.user_time + sample.system_time) - (previous.user_time + previous.system_time);
+        if (elapsed > 0.0)
+          sample.cpu_usage = cpu_elapsed / elapsed * 100.0;
+      }
+
+      //push in the ring buffer, overwriting the oldest sample if full
+      if (history.count < capacity_) {
+        history.samples[(history.first + history.count) % capacity_] = sample;
+        history.count++;
+      }
+      else {
+        history.samples[history.first] = sample;
+        history.first = (history.first + 1) % capacity_;
+      }
+      history.total++;
+    }
+
+    last_sample_time_ = ra::timing::GetMicrosecondsTimer();
+    return num_running;
+  }
+
+  bool ResourceSampler::Update() {
+    double now = ra::timing::GetMicrosecondsTimer();
+    if (last_sample_time_ != 0.0 && (now - last_sample_time_) * 1000.0 < (double)interval_)
+      return false;
+    Sample();
+    return true;
+  }
+
+  size_t ResourceSampler::Run(uint32_t duration) {
+    const double time_start = ra::timing::GetMicrosecondsTimer();
+    while (true) {
+      size_t num_running = Sample();
+      if (num_running == 0)
+        return 0;
+
+      double elapsed = (ra::timing::GetMicrosecondsTimer() - time_start) * 1000.0;
+      if (elapsed >= (double)duration)
+        return num_running;
+
+      double remaining = (double)duration - elapsed;
+      ra::timing::Millisleep((uint32_t)(remaining < (double)interval_ ? remaining : (double)interval_));
+    }
+  }
+
+  bool ResourceSampler::GetSamples(const processid_t & pid, ResourceSampleList & samples) const {
+    samples.clear();
+    HistoryMap::const_iterator it = histories_.find(pid);
+    if (it == histories_.end())
+      return false;
+
+    const History & history = it->second;
+    samples.reserve(history.count);
+    for (size_t i = 0; i < history.count; i++) {
+      samples.push_back(history.samples[(history.first + i) % capacity_]);
+    }
+    return true;
+  }
+
+  bool ResourceSampler::GetSummary(const processid_t & pid, ResourceSummary & summary) const {
+    memset(&summary, 0, sizeof(summary));
+    HistoryMap::const_iterator it = histories_.find(pid);
+    if (it == histories_.end() || it->second.count == 0)
+      return false;
+
+    const History & history = it->second;
+    const ResourceSample & last = history.samples[(history.first + history.count - 1) % capacity_];
+    summary.pid = pid;
+    summary.running = history.running;
+    summary.num_samples = history.count;
+    summary.cpu_time = last.user_time + last.system_time;
+    summary.read_bytes = last.read_bytes;
+    summary.write_bytes = last.write_bytes;
+
+    //the very first sample of a process has no cpu usage
+    size_t first_cpu_sample = (history.total == history.count && history.count > 1 ? 1 : 0);
+
+    std::vector<double> values;
+    values.reserve(history.count);
+    for (size_t i = first_cpu_sample; i < history.count; i++) {
+      values.push_back(history.samples[(history.first + i) % capacity_].cpu_usage);
+    }
+    ComputeStatistics(values, summary.cpu_usage);
+
+    values.clear();
+    for (size_t i = 0; i < history.count; i++) {
+      values.push_back((double)history.samples[(history.first + i) % capacity_].rss);
+    }
+    ComputeStatistics(values, summary.rss);
+
+    return true;
+  }
+
+  ResourceSummaryList ResourceSampler::GetSummaries() const {
+    ResourceSummaryList summaries;
+    for (HistoryMap::const_iterator it = histories_.begin(); it != histories_.end(); it++) {
+      ResourceSummary summary;
+      if (GetSummary(it->first, summary))
+        summaries.push_back(summary);
+    }
+    std::stable_sort(summaries.begin(), summaries.end(), IsHigherCpuTime);
+    return summaries;
+  }
+
+  void AppendStatistics(std::string & output, const ResourceStatistics & stats, const char * separator) {
+    output += ra::strings::ToStringFormatted(stats.min, 3) + separator;
+    output += ra::strings::ToStringFormatted(stats.max, 3) + separator;
+    output += ra::strings::ToStringFormatted(stats.avg, 3) + separator;
+    output += ra::strings::ToStringFormatted(stats.p50, 3) + separator;
+    output += ra::strings::ToStringFormatted(stats.p90, 3) + separator;
+    output += ra::strings::ToStringFormatted(stats.p99, 3);
+  }
+
+  std::string ToCsv(const ResourceSummaryList & summaries) {
+    std::string output;
+    output += "pid,running,samples,cpu_time,read_bytes,write_bytes,"
+              "cpu_min,cpu_max,cpu_avg,cpu_p50,cpu_p90,cpu_p99,"
+              "rss_min,rss_max,rss_avg,rss_p50,rss_p90,rss_p99\n";
+    for (size_t i = 0; i < summaries.size(); i++) {
+      const ResourceSummary & summary = summaries[i];
+      output += ra::strings::ToString(summary.pid) + ",";
+      output += ra::strings::ToString(summary.running) + ",";
+      output += ra::strings::ToString((uint64_t)summary.num_samples) + ",";
+      output += ra::strings::ToStringFormatted(summary.cpu_time, 3) + ",";
+      output += ra::strings::ToString(summary.read_bytes) + ",";
+      output += ra::strings::ToString(summary.write_bytes) + ",";
+      AppendStatistics(output, summary.cpu_usage, ",");
+      output += ",";
+      AppendStatistics(output, summary.rss, ",");
+      output += "\n";
+    }
+    return output;
+  }
+
+  void AppendJsonStatistics(std::string & output, const char * name, const ResourceStatistics & stats) {
+    output += "\"";
+    output += name;
+    output += "\": {";
+    output += "\"min\": " + ra::strings::ToStringFormatted(stats.min, 3) + ", ";
+    output += "\"max\": " + ra::strings::ToStringFormatted(stats.max, 3) + ", ";
+    output += "\"avg\": " + ra::strings::ToStringFormatted(stats.avg, 3) + ", ";
+    output += "\"p50\": " + ra::strings::ToStringFormatted(stats.p50, 3) + ", ";
+    output += "\"p90\": " + ra::strings::ToStringFormatted(stats.p90, 3) + ", ";
+    output += "\"p99\": " + ra::strings::ToStringFormatted(stats.p99, 3) + "}";
+  }
+
+  std::string ToJson(const ResourceSummaryList & summaries) {
+    std::string output = "[";
+    for (size_t i = 0; i < summaries.size(); i++) {
+      const ResourceSummary & summary = summaries[i];
+      if (i > 0)
+        output += ",";
+      output += "\n  {";
+      output += "\"pid\": " + ra::strings::ToString(summary.pid) + ", ";
+      output += std::string("\"running\": ") + (summary.running ? "true" : "false") + ", ";
+      output += "\"samples\": " + ra::strings::ToString((uint64_t)summary.num_samples) + ", ";
+      output += "\"cpu_time\": " + ra::strings::ToStringFormatted(summary.cpu_time, 3) + ", ";
+      output += "\"read_bytes\": " + ra::strings::ToString(summary.read_bytes) + ", ";
+      output += "\"write_bytes\": " + ra::strings::ToString(summary.write_bytes) + ", ";
+      AppendJsonStatistics(output, "cpu_usage", summary.cpu_usage);
+      output += ", ";
+      AppendJsonStatistics(output, "rss", summary.rss);
+      output += "}";
+    }
+    if (!summaries.empty())
+      output += "\n";
+    output += "]";
+    return output;
+  }
+
+} //namespace process
+} //namespace ra
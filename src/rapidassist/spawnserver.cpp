@@ -0,0 +1,612 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/spawnserver.h"
+
+#ifndef _WIN32
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+extern char **environ;
+
+namespace ra { namespace process {
+
+  enum MessageType {
+    REQUEST_EXEC = 1,
+    REQUEST_ENTRY_POINT = 2,
+    REPLY_SPAWNED = 10,
+    REPLY_FAILED = 11,
+    REPLY_EXITED = 12,
+  };
+
+  /// <summary>
+  /// Header of a launch request. The header is followed by num_strings NULL terminated strings:
+  /// the executable path (or entry point name), the default directory and the process arguments.
+  /// </summary>
+  struct RequestHeader {
+    uint32_t type;
+    uint32_t capture_output;
+    uint32_t num_strings;
+  };
+
+  /// <summary>
+  /// Message sent by the helper process to the client.
+  /// A REPLY_SPAWNED message may also contain the standard output and standard error file descriptors of the new process.
+  /// </summary>
+  struct ReplyMessage {
+    uint32_t type;
+    int32_t pid;
+    int32_t value; //errno for REPLY_FAILED, exit code for REPLY_EXITED.
+  };
+
+  static const size_t NUM_OUTPUT_FDS = 2;
+
+  ///=========================================================================================
+  ///                                 Helper process functions
+  ///=========================================================================================
+
+  static int g_sigchld_pipe[2] = { -1, -1 };
+
+  static void OnChildSignal(int) {
+    int saved_errno = errno;
+    char c = 0;
+    ssize_t ignored = write(g_sigchld_pipe[1], &c, 1);
+    (void)ignored;
+    errno = saved_errno;
+  }
+
+  bool SendReply(int fd, uint32_t type, processid_t pid, int value, const int * fds, size_t num_fds) {
+    ReplyMessage reply;
+    reply.type = type;
+    reply.pid = (int32_t)pid;
+    reply.value = (int32_t)value;
+
+    struct iovec iov;
+    iov.iov_base = &reply;
+    iov.iov_len = sizeof(reply);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    char control[CMSG_SPACE(sizeof(int) * NUM_OUTPUT_FDS)];
+    if (fds != NULL && num_fds > 0) {
+      memset(control, 0, sizeof(control));
+      msg.msg_control = control;
+      msg.msg_controllen = CMSG_SPACE(sizeof(int) * num_fds);
+      struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+      cmsg->cmsg_level = SOL_SOCKET;
+      cmsg->cmsg_type = SCM_RIGHTS;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(int) * num_fds);
+      memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * num_fds);
+    }
+
+    ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    return (sent == (ssize_t)sizeof(reply));
+  }
+
+  void CloseOutputPipes(int pipes[NUM_OUTPUT_FDS][2]) {
+    for (size_t i = 0; i < NUM_OUTPUT_FDS; i++) {
+      for (size_t j = 0; j < 2; j++) {
+        if (pipes[i][j] != -1)
+          close(pipes[i][j]);
+        pipes[i][j] = -1;
+      }
+    }
+  }
+
+  bool CreateOutputPipes(int pipes[NUM_OUTPUT_FDS][2]) {
+    for (size_t i = 0; i < NUM_OUTPUT_FDS; i++) {
+      if (pipe2(pipes[i], O_CLOEXEC) != 0) {
+        CloseOutputPipes(pipes);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void ProcessRequest(int fd, const char * buffer, size_t size, const SpawnServer::EntryPointMap & entry_points) {
+    if (size < sizeof(RequestHeader)) {
+      SendReply(fd, REPLY_FAILED, INVALID_PROCESS_ID, EINVAL, NULL, 0);
+      return;
+    }
+    RequestHeader header;
+    memcpy(&header, buffer, sizeof(header));
+
+    //read all strings from the request
+    ra::strings::StringVector strings;
+    const char * str = buffer + sizeof(RequestHeader);
+    const char * end = buffer + size;
+    for (uint32_t i = 0; i < header.num_strings && str < end; i++) {
+      size_t length = strnlen(str, end - str);
+      strings.push_back(std::string(str, length));
+      str += length + 1;
+    }
+    if (strings.size() < 2 || strings.size() != header.num_strings) {
+      SendReply(fd, REPLY_FAILED, INVALID_PROCESS_ID, EINVAL, NULL, 0);
+      return;
+    }
+    const std::string & target = strings[0];
+    const std::string & directory = strings[1];
+
+    int pipes[NUM_OUTPUT_FDS][2] = { { -1, -1 }, { -1, -1 } };
+    bool capture_output = (header.capture_output != 0);
+    if (capture_output && !CreateOutputPipes(pipes)) {
+      SendReply(fd, REPLY_FAILED, INVALID_PROCESS_ID, errno, NULL, 0);
+      return;
+    }
+
+    pid_t child_pid = INVALID_PROCESS_ID;
+    int error = 0;
+    if (header.type == REQUEST_EXEC) {
+      if (!directory.empty() && chdir(directory.c_str()) != 0) {
+        error = errno;
+      }
+      else {
+        //prepare argv
+        //the first element of argv must be the executable path itself.
+        //the last element of argv must be am empty argument
+        std::vector<char *> argv;
+        argv.push_back((char*)target.c_str());
+        for (size_t i = 2; i < strings.size(); i++) {
+          argv.push_back((char*)strings[i].c_str());
+        }
+        argv.push_back(NULL);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (capture_output) {
+          posix_spawn_file_actions_adddup2(&actions, pipes[0][1], STDOUT_FILENO);
+          posix_spawn_file_actions_adddup2(&actions, pipes[1][1], STDERR_FILENO);
+        }
+
+        //restore the default SIGCHLD handler in the new process
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t default_signals;
+        sigemptyset(&default_signals);
+        sigaddset(&default_signals, SIGCHLD);
+        posix_spawnattr_setsigdefault(&attr, &default_signals);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+        error = posix_spawn(&child_pid, target.c_str(), &actions, &attr, &argv[0], environ);
+        if (error != 0)
+          child_pid = INVALID_PROCESS_ID;
+
+        posix_spawnattr_destroy(&attr);
+        posix_spawn_file_actions_destroy(&actions);
+      }
+    }
+    else if (header.type == REQUEST_ENTRY_POINT) {
+      SpawnServer::EntryPointMap::const_iterator it = entry_points.find(target);
+      if (it == entry_points.end()) {
+        error = ENOENT;
+      }
+      else {
+        child_pid = fork();
+        if (child_pid == 0) {
+          //new process
+          close(fd);
+          close(g_sigchld_pipe[0]);
+          close(g_sigchld_pipe[1]);
+          signal(SIGCHLD, SIG_DFL);
+          if (capture_output) {
+            dup2(pipes[0][1], STDOUT_FILENO);
+            dup2(pipes[1][1], STDERR_FILENO);
+            CloseOutputPipes(pipes);
+          }
+          if (!directory.empty() && chdir(directory.c_str()) != 0)
+            _exit(127);
+
+          ra::strings::StringVector args(strings.begin() + 2, strings.end());
+          int exitcode = it->second(args);
+          fflush(NULL);
+          _exit(exitcode);
+        }
+        else if (child_pid < 0) {
+          error = errno;
+          child_pid = INVALID_PROCESS_ID;
+        }
+      }
+    }
+    else {
+      error = EINVAL;
+    }
+
+    if (child_pid == INVALID_PROCESS_ID) {
+      CloseOutputPipes(pipes);
+      SendReply(fd, REPLY_FAILED, INVALID_PROCESS_ID, error, NULL, 0);
+      return;
+    }
+
+    //send the read end of the output pipes to the client
+    if (capture_output) {
+      int fds[NUM_OUTPUT_FDS] = { pipes[0][0], pipes[1][0] };
+      SendReply(fd, REPLY_SPAWNED, child_pid, 0, fds, NUM_OUTPUT_FDS);
+    }
+    else {
+      SendReply(fd, REPLY_SPAWNED, child_pid, 0, NULL, 0);
+    }
+    CloseOutputPipes(pipes);
+  }
+
+  void ReapChildren(int fd) {
+    int status = 0;
+    pid_t pid = 0;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+      int exitcode = 0;
+      if (WIFEXITED(status))
+        exitcode = WEXITSTATUS(status);
+      else if (WIFSIGNALED(status))
+        exitcode = 128 + WTERMSIG(status);
+      SendReply(fd, REPLY_EXITED, pid, exitcode, NULL, 0);
+    }
+  }
+
+  void RunServer(int fd, const SpawnServer::EntryPointMap & entry_points) {
+    if (pipe2(g_sigchld_pipe, O_CLOEXEC | O_NONBLOCK) != 0)
+      return;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &OnChildSignal;
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGCHLD, &action, NULL) != 0)
+      return;
+
+    std::vector<char> buffer;
+    while (true) {
+      struct pollfd fds[2];
+      fds[0].fd = fd;
+      fds[0].events = POLLIN;
+      fds[0].revents = 0;
+      fds[1].fd = g_sigchld_pipe[0];
+      fds[1].events = POLLIN;
+      fds[1].revents = 0;
+
+      int result = poll(fds, 2, -1);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        return;
+      }
+
+      if (fds[1].revents & POLLIN) {
+        char tmp[64];
+        while (read(g_sigchld_pipe[0], tmp, sizeof(tmp)) > 0) {
+        }
+        ReapChildren(fd);
+      }
+
+      if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        //peek for the size of the next request
+        ssize_t size = recv(fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+        if (size <= 0) {
+          if (size < 0 && errno == EINTR)
+            continue;
+          return; //client is gone
+        }
+        buffer.resize((size_t)size);
+        size = recv(fd, &buffer[0], buffer.size(), 0);
+        if (size <= 0)
+          return;
+        ProcessRequest(fd, &buffer[0], (size_t)size, entry_points);
+      }
+    }
+  }
+
+  ///=========================================================================================
+  ///                                 SpawnServer class
+  ///=========================================================================================
+
+  SpawnServer::SpawnServer() :
+    server_pid_(INVALID_PROCESS_ID),
+    socket_fd_(-1),
+    last_spawned_pid_(INVALID_PROCESS_ID),
+    last_spawn_completed_(false) {
+  }
+
+  SpawnServer::~SpawnServer() {
+    Stop();
+  }
+
+  bool SpawnServer::RegisterEntryPoint(const std::string & name, EntryPointFunc func) {
+    if (IsStarted() || name.empty() || func == NULL)
+      return false;
+    entry_points_[name] = func;
+    return true;
+  }
+
+  bool SpawnServer::Start() {
+    if (IsStarted())
+      return true;
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0)
+      return false;
+
+    //do not duplicate pending buffered output in the helper process
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return false;
+    }
+    if (pid == 0) {
+      //helper process
+      close(fds[0]);
+#ifdef __linux__
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+      RunServer(fds[1], entry_points_);
+      _exit(0);
+    }
+
+    close(fds[1]);
+    socket_fd_ = fds[0];
+    server_pid_ = pid;
+    return true;
+  }
+
+  bool SpawnServer::Stop() {
+    if (!IsStarted())
+      return true;
+
+    //closing the socket requests the helper process to exit
+    close(socket_fd_);
+    socket_fd_ = -1;
+    int status = 0;
+    waitpid(server_pid_, &status, 0);
+    server_pid_ = INVALID_PROCESS_ID;
+
+    for (ChildMap::iterator it = children_.begin(); it != children_.end(); it++) {
+      ChildInfo & child = it->second;
+      if (child.output_fd != -1)
+        close(child.output_fd);
+      if (child.errors_fd != -1)
+        close(child.errors_fd);
+    }
+    children_.clear();
+
+    return true;
+  }
+
+  bool SpawnServer::IsStarted() const {
+    return (socket_fd_ != -1);
+  }
+
+  processid_t SpawnServer::GetServerProcessId() const {
+    return server_pid_;
+  }
+
+  processid_t SpawnServer::Spawn(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & args, bool capture_output) {
+    return SendRequest(REQUEST_EXEC, exec_path, default_directory, args, capture_output);
+  }
+
+  processid_t SpawnServer::SpawnEntryPoint(const std::string & name, const ra::strings::StringVector & args, bool capture_output) {
+    return SendRequest(REQUEST_ENTRY_POINT, name, "", args, capture_output);
+  }
+
+  processid_t SpawnServer::SendRequest(int type, const std::string & target, const std::string & directory, const ra::strings::StringVector & args, bool capture_output) {
+    if (!IsStarted() || target.empty())
+      return INVALID_PROCESS_ID;
+
+    RequestHeader header;
+    header.type = (uint32_t)type;
+    header.capture_output = (capture_output ? 1 : 0);
+    header.num_strings = (uint32_t)(2 + args.size());
+
+    std::string request;
+    request.append((const char *)&header, sizeof(header));
+    request.append(target.c_str(), target.size() + 1);
+    request.append(directory.c_str(), directory.size() + 1);
+    for (size_t i = 0; i < args.size(); i++) {
+      request.append(args[i].c_str(), args[i].size() + 1);
+    }
+
+    ssize_t sent = send(socket_fd_, request.data(), request.size(), MSG_NOSIGNAL);
+    if (sent != (ssize_t)request.size())
+      return INVALID_PROCESS_ID;
+
+    //wait for the helper process to reply
+    last_spawned_pid_ = INVALID_PROCESS_ID;
+    last_spawn_completed_ = false;
+    while (!last_spawn_completed_) {
+      if (!ReceiveMessage(true))
+        return INVALID_PROCESS_ID;
+    }
+    return last_spawned_pid_;
+  }
+
+  bool SpawnServer::ReceiveMessage(bool blocking) {
+    if (!IsStarted())
+      return false;
+
+    ReplyMessage reply;
+    struct iovec iov;
+    iov.iov_base = &reply;
+    iov.iov_len = sizeof(reply);
+
+    char control[CMSG_SPACE(sizeof(int) * NUM_OUTPUT_FDS)];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t size = -1;
+    do {
+      size = recvmsg(socket_fd_, &msg, MSG_CMSG_CLOEXEC | (blocking ? 0 : MSG_DONTWAIT));
+    } while (size < 0 && errno == EINTR);
+    if (size != (ssize_t)sizeof(reply))
+      return false;
+
+    //extract the output file descriptors, if any
+    int fds[NUM_OUTPUT_FDS] = { -1, -1 };
+    for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(fds))) {
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+      }
+    }
+
+    switch (reply.type) {
+    case REPLY_SPAWNED:
+    {
+      ChildInfo child;
+      child.output_fd = fds[0];
+      child.errors_fd = fds[1];
+      child.exited = false;
+      child.exitcode = 0;
+      children_[(processid_t)reply.pid] = child;
+      last_spawned_pid_ = (processid_t)reply.pid;
+      last_spawn_completed_ = true;
+    }
+    break;
+    case REPLY_FAILED:
+      last_spawned_pid_ = INVALID_PROCESS_ID;
+      last_spawn_completed_ = true;
+      break;
+    case REPLY_EXITED:
+    {
+      ChildMap::iterator it = children_.find((processid_t)reply.pid);
+      if (it != children_.end()) {
+        it->second.exited = true;
+        it->second.exitcode = reply.value;
+      }
+    }
+    break;
+    default:
+      break;
+    };
+
+    return true;
+  }
+
+  bool SpawnServer::ReadOutputs(const processid_t & pid, std::string & output, std::string & errors) {
+    ChildMap::iterator it = children_.find(pid);
+    if (it == children_.end())
+      return false;
+    ChildInfo & child = it->second;
+
+    //read both streams simultaneously to prevent the process from blocking on a full pipe
+    int * fds[NUM_OUTPUT_FDS] = { &child.output_fd, &child.errors_fd };
+    std::string * streams[NUM_OUTPUT_FDS] = { &output, &errors };
+    char buffer[4096];
+    while (child.output_fd != -1 || child.errors_fd != -1) {
+      struct pollfd pfds[NUM_OUTPUT_FDS];
+      for (size_t i = 0; i < NUM_OUTPUT_FDS; i++) {
+        pfds[i].fd = *fds[i];
+        pfds[i].events = POLLIN;
+        pfds[i].revents = 0;
+      }
+      int result = poll(pfds, NUM_OUTPUT_FDS, -1);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      for (size_t i = 0; i < NUM_OUTPUT_FDS; i++) {
+        if (pfds[i].fd == -1 || pfds[i].revents == 0)
+          continue;
+        ssize_t size = read(pfds[i].fd, buffer, sizeof(buffer));
+        if (size > 0) {
+          streams[i]->append(buffer, (size_t)size);
+        }
+        else if (size == 0 || errno != EINTR) {
+          close(*fds[i]);
+          *fds[i] = -1;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool SpawnServer::GetExitCode(const processid_t & pid, int & exitcode) {
+    //process all pending notifications
+    while (ReceiveMessage(false)) {
+    }
+
+    ChildMap::iterator it = children_.find(pid);
+    if (it == children_.end() || !it->second.exited)
+      return false;
+
+    //the exit code can only be read once
+    ChildInfo & child = it->second;
+    exitcode = child.exitcode;
+    if (child.output_fd != -1)
+      close(child.output_fd);
+    if (child.errors_fd != -1)
+      close(child.errors_fd);
+    children_.erase(it);
+    return true;
+  }
+
+  bool SpawnServer::WaitExit(const processid_t & pid, int & exitcode) {
+    std::string output;
+    std::string errors;
+    bool success = WaitExit(pid, exitcode, output, errors);
+    return success;
+  }
+
+  bool SpawnServer::WaitExit(const processid_t & pid, int & exitcode, std::string & output, std::string & errors) {
+    output.clear();
+    errors.clear();
+
+    ChildMap::iterator it = children_.find(pid);
+    if (it == children_.end())
+      return false;
+
+    if (!ReadOutputs(pid, output, errors))
+      return false;
+
+    //wait for the helper process to notify the process termination
+    while (!children_[pid].exited) {
+      if (!ReceiveMessage(true))
+        return false;
+    }
+
+    bool success = GetExitCode(pid, exitcode);
+    return success;
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
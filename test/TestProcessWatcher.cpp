@@ -0,0 +1,137 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestProcessWatcher.h"
+#include "rapidassist/processwatcher.h"
+#include "rapidassist/process.h"
+#include "rapidassist/generics.h"
+#include "rapidassist/timing.h"
+
+#include <algorithm>
+
+namespace ra { namespace process { namespace test
+{
+  bool Contains(const ProcessIdList & processes, const processid_t & pid) {
+    return std::find(processes.begin(), processes.end(), pid) != processes.end();
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessWatcher::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessWatcher::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessWatcher, testStartStop) {
+    ProcessWatcher watcher;
+    ASSERT_FALSE(watcher.IsStarted());
+
+    //polling is not possible when stopped
+    ProcessDelta delta;
+    ASSERT_FALSE(watcher.Poll(delta));
+
+    ASSERT_TRUE(watcher.Start());
+    ASSERT_TRUE(watcher.IsStarted());
+    ASSERT_FALSE(watcher.IsEventDriven());
+
+    //the current process must be in the initial snapshot
+    const ProcessSnapshot & snapshot = watcher.GetSnapshot();
+    ASSERT_FALSE(snapshot.empty());
+    ASSERT_NE(ra::generics::INVALID_INDEX, snapshot.FindIndex(ra::process::GetCurrentProcessId()));
+
+    ASSERT_TRUE(watcher.Poll(delta));
+    ASSERT_FALSE(Contains(delta.started, ra::process::GetCurrentProcessId()));
+    ASSERT_FALSE(Contains(delta.exited, ra::process::GetCurrentProcessId()));
+
+    ASSERT_TRUE(watcher.Stop());
+    ASSERT_FALSE(watcher.IsStarted());
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestProcessWatcher, testPollStartedExited) {
+    ProcessWatcher watcher;
+    ASSERT_TRUE(watcher.Start());
+
+    ra::strings::StringVector args;
+    args.push_back("1");
+    processid_t pid = ra::process::StartProcess("/bin/sleep", ra::process::GetCurrentProcessDir(), args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    ProcessDelta delta;
+    ASSERT_TRUE(watcher.Poll(delta));
+    ASSERT_TRUE(Contains(delta.started, pid));
+    ASSERT_FALSE(Contains(delta.exited, pid));
+    ASSERT_NE(ra::generics::INVALID_INDEX, watcher.GetSnapshot().FindIndex(pid));
+
+    //a process is removed from the process table once reaped
+    int exitcode = -1;
+    ASSERT_TRUE(ra::process::WaitExit(pid, exitcode));
+
+    ASSERT_TRUE(watcher.Poll(delta));
+    ASSERT_FALSE(Contains(delta.started, pid));
+    ASSERT_TRUE(Contains(delta.exited, pid));
+    ASSERT_EQ(ra::generics::INVALID_INDEX, watcher.GetSnapshot().FindIndex(pid));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessWatcher, testPollEvents) {
+    ProcessWatcher watcher;
+    ASSERT_TRUE(watcher.Start(true));
+    if (!watcher.IsEventDriven()) {
+      printf("Skipping event driven mode tests. The kernel proc connector is not available.\n");
+      return;
+    }
+
+    ra::strings::StringVector args;
+    args.push_back("0");
+    processid_t pid = ra::process::StartProcess("/bin/sleep", ra::process::GetCurrentProcessDir(), args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    int exitcode = -1;
+    ASSERT_TRUE(ra::process::WaitExit(pid, exitcode));
+
+    ProcessDelta delta;
+    ASSERT_TRUE(watcher.Poll(delta));
+    ASSERT_TRUE(Contains(delta.started, pid));
+    ASSERT_TRUE(Contains(delta.executed, pid));
+    ASSERT_TRUE(Contains(delta.exited, pid));
+    ASSERT_EQ(ra::generics::INVALID_INDEX, watcher.GetSnapshot().FindIndex(pid));
+  }
+#endif //_WIN32
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessWatcher, testBenchmarkPoll) {
+    static const size_t NUM_POLLS = 200;
+    ProcessWatcher watcher;
+    ASSERT_TRUE(watcher.Start());
+
+    ProcessDelta delta;
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_POLLS; i++) {
+      ASSERT_TRUE(watcher.Poll(delta));
+    }
+    double elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+
+    printf("Time per ProcessWatcher::Poll() calls: %.3fus (%s processes)\n", elapsed / NUM_POLLS * 1000000.0, ra::strings::ToString(watcher.GetSnapshot().size()).c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace process
+} //namespace ra
@@ -0,0 +1,177 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestResourceSampler.h"
+#include "rapidassist/resourcesampler.h"
+#include "rapidassist/process.h"
+#include "rapidassist/strings.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestResourceSampler::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestResourceSampler::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestResourceSampler, testGetResourceSample) {
+    //burn some cpu time
+    volatile double value = 0.0;
+    for (int i = 0; i < 10000000; i++) {
+      value += i * 0.5;
+    }
+
+    ResourceSample sample;
+    ASSERT_TRUE(GetResourceSample(ra::process::GetCurrentProcessId(), sample));
+    ASSERT_GT(sample.user_time + sample.system_time, 0.0);
+    ASSERT_GT(sample.rss, (uint64_t)0);
+    ASSERT_GE(sample.virtual_size, sample.rss);
+    ASSERT_GT(sample.timestamp, 0.0);
+
+    //invalid process
+    ASSERT_FALSE(GetResourceSample(ra::process::INVALID_PROCESS_ID, sample));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestResourceSampler, testAddRemoveProcess) {
+    ResourceSampler sampler;
+    processid_t pid = ra::process::GetCurrentProcessId();
+    ASSERT_TRUE(sampler.AddProcess(pid));
+    ASSERT_FALSE(sampler.AddProcess(pid));
+    ASSERT_EQ(1, sampler.GetProcesses().size());
+
+    //no sample yet
+    ResourceSummary summary;
+    ASSERT_FALSE(sampler.GetSummary(pid, summary));
+
+    ASSERT_TRUE(sampler.RemoveProcess(pid));
+    ASSERT_FALSE(sampler.RemoveProcess(pid));
+    ASSERT_TRUE(sampler.GetProcesses().empty());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestResourceSampler, testRingBuffer) {
+    static const size_t CAPACITY = 5;
+    ResourceSampler sampler(CAPACITY);
+    processid_t pid = ra::process::GetCurrentProcessId();
+    ASSERT_TRUE(sampler.AddProcess(pid));
+
+    for (size_t i = 0; i < 3; i++) {
+      ASSERT_EQ(1, sampler.Sample());
+    }
+    ResourceSampleList samples;
+    ASSERT_TRUE(sampler.GetSamples(pid, samples));
+    ASSERT_EQ(3, samples.size());
+
+    for (size_t i = 0; i < 10; i++) {
+      ASSERT_EQ(1, sampler.Sample());
+    }
+    ASSERT_TRUE(sampler.GetSamples(pid, samples));
+    ASSERT_EQ(CAPACITY, samples.size());
+
+    //assert samples are ordered from the oldest to the newest
+    for (size_t i = 1; i < samples.size(); i++) {
+      ASSERT_GE(samples[i].timestamp, samples[i - 1].timestamp);
+      ASSERT_GE(samples[i].user_time, samples[i - 1].user_time);
+    }
+
+    ResourceSummary summary;
+    ASSERT_TRUE(sampler.GetSummary(pid, summary));
+    ASSERT_EQ(pid, summary.pid);
+    ASSERT_TRUE(summary.running);
+    ASSERT_EQ(CAPACITY, summary.num_samples);
+    ASSERT_LE(summary.rss.min, summary.rss.p50);
+    ASSERT_LE(summary.rss.p50, summary.rss.p90);
+    ASSERT_LE(summary.rss.p90, summary.rss.p99);
+    ASSERT_LE(summary.rss.p99, summary.rss.max);
+    ASSERT_LE(summary.rss.min, summary.rss.avg);
+    ASSERT_LE(summary.rss.avg, summary.rss.max);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestResourceSampler, testUpdate) {
+    ResourceSampler sampler;
+    sampler.SetInterval(100);
+    ASSERT_EQ(100, sampler.GetInterval());
+    ASSERT_TRUE(sampler.AddProcess(ra::process::GetCurrentProcessId()));
+
+    ASSERT_TRUE(sampler.Update());  //first sample is always taken
+    ASSERT_FALSE(sampler.Update()); //interval not elapsed
+    ra::timing::Millisleep(150);
+    ASSERT_TRUE(sampler.Update());
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestResourceSampler, testRunUntilExit) {
+    ra::strings::StringVector args;
+    args.push_back("-c");
+    args.push_back("i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done");
+    processid_t pid = ra::process::StartProcess("/bin/sh", ra::process::GetCurrentProcessDir(), args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    ResourceSampler sampler;
+    sampler.SetInterval(10);
+    ASSERT_TRUE(sampler.AddProcess(pid));
+    ASSERT_EQ(0, sampler.Run(30000));
+
+    ResourceSummary summary;
+    ASSERT_TRUE(sampler.GetSummary(pid, summary));
+    ASSERT_FALSE(summary.running);
+    ASSERT_GT(summary.num_samples, (size_t)0);
+    ASSERT_GT(summary.rss.max, 0.0);
+
+    int exitcode = -1;
+    ASSERT_TRUE(ra::process::WaitExit(pid, exitcode));
+    ASSERT_EQ(0, exitcode);
+  }
+#endif //_WIN32
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestResourceSampler, testToCsvJson) {
+    ResourceSampler sampler;
+    processid_t pid = ra::process::GetCurrentProcessId();
+    ASSERT_TRUE(sampler.AddProcess(pid));
+    sampler.Sample();
+    sampler.Sample();
+
+    ResourceSummaryList summaries = sampler.GetSummaries();
+    ASSERT_EQ(1, summaries.size());
+
+    std::string csv = ToCsv(summaries);
+    ra::strings::StringVector lines = ra::strings::Split(csv, "\n");
+    ASSERT_GE(lines.size(), (size_t)2);
+    ASSERT_EQ(0, lines[0].find("pid,running,samples,cpu_time,"));
+    ASSERT_EQ(0, lines[1].find(ra::strings::ToString(pid) + ",true,2,"));
+    ASSERT_EQ(ra::strings::Split(lines[0], ",").size(), ra::strings::Split(lines[1], ",").size());
+
+    std::string json = ToJson(summaries);
+    ASSERT_EQ('[', json[0]);
+    ASSERT_EQ(']', json[json.size() - 1]);
+    ASSERT_NE(std::string::npos, json.find("\"pid\": " + ra::strings::ToString(pid) + ","));
+    ASSERT_NE(std::string::npos, json.find("\"cpu_usage\": {\"min\": "));
+
+    ASSERT_EQ(std::string("[]"), ToJson(ResourceSummaryList()));
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace process
+} //namespace ra
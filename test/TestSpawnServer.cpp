@@ -0,0 +1,244 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestSpawnServer.h"
+#include "rapidassist/spawnserver.h"
+#include "rapidassist/process.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+#ifndef _WIN32
+#include <sys/wait.h> //for waitpid()
+#endif
+
+namespace ra { namespace process { namespace test
+{
+#ifndef _WIN32
+  int EntryPointExitCode(const ra::strings::StringVector & args) {
+    int exitcode = 0;
+    if (!args.empty())
+      ra::strings::Parse(args[0], exitcode);
+    return exitcode;
+  }
+  //--------------------------------------------------------------------------------------------------
+  int EntryPointPrint(const ra::strings::StringVector & args) {
+    printf("%s", ra::strings::Join(args, " ").c_str());
+    fprintf(stderr, "%d", (int)args.size());
+    return 0;
+  }
+  //--------------------------------------------------------------------------------------------------
+  int EntryPointTrue(const ra::strings::StringVector & args) {
+    return 0;
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+  void TestSpawnServer::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestSpawnServer::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestSpawnServer, testStartStop) {
+    SpawnServer server;
+    ASSERT_FALSE(server.IsStarted());
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, server.GetServerProcessId());
+
+    ASSERT_TRUE(server.Start());
+    ASSERT_TRUE(server.IsStarted());
+    processid_t server_pid = server.GetServerProcessId();
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, server_pid);
+    ASSERT_TRUE(ra::process::IsRunning(server_pid));
+
+    //entry points cannot be registered once started
+    ASSERT_FALSE(server.RegisterEntryPoint("true", &EntryPointTrue));
+
+    ASSERT_TRUE(server.Stop());
+    ASSERT_FALSE(server.IsStarted());
+    ASSERT_FALSE(ra::process::IsRunning(server_pid));
+
+    //spawning is not possible when stopped
+    ra::strings::StringVector args;
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, server.Spawn("/bin/true", "", args));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testSpawn) {
+    SpawnServer server;
+    ASSERT_TRUE(server.Start());
+
+    ra::strings::StringVector args;
+    args.push_back("-c");
+    args.push_back("exit 42");
+    processid_t pid = server.Spawn("/bin/sh", ra::process::GetCurrentProcessDir(), args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    int exitcode = 0;
+    ASSERT_TRUE(server.WaitExit(pid, exitcode));
+    ASSERT_EQ(42, exitcode);
+
+    //the exit code can only be read once
+    ASSERT_FALSE(server.GetExitCode(pid, exitcode));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testSpawnInvalid) {
+    SpawnServer server;
+    ASSERT_TRUE(server.Start());
+
+    ra::strings::StringVector args;
+    processid_t pid = server.Spawn("/bin/this_executable_does_not_exist", "", args);
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, pid);
+
+    //invalid directory
+    pid = server.Spawn("/bin/true", "/this/directory/does/not/exist", args);
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, pid);
+
+    //the server must still be usable
+    pid = server.Spawn("/bin/true", "", args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    int exitcode = -1;
+    ASSERT_TRUE(server.WaitExit(pid, exitcode));
+    ASSERT_EQ(0, exitcode);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testSpawnCaptureOutput) {
+    SpawnServer server;
+    ASSERT_TRUE(server.Start());
+
+    ra::strings::StringVector args;
+    args.push_back("-c");
+    args.push_back("echo hello; echo world 1>&2; pwd");
+    processid_t pid = server.Spawn("/bin/sh", "/", args, true);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    int exitcode = -1;
+    std::string output;
+    std::string errors;
+    ASSERT_TRUE(server.WaitExit(pid, exitcode, output, errors));
+    ASSERT_EQ(0, exitcode);
+    ASSERT_EQ(std::string("hello\n/\n"), output);
+    ASSERT_EQ(std::string("world\n"), errors);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testSpawnEntryPoint) {
+    SpawnServer server;
+    ASSERT_TRUE(server.RegisterEntryPoint("exitcode", &EntryPointExitCode));
+    ASSERT_TRUE(server.RegisterEntryPoint("print", &EntryPointPrint));
+    ASSERT_TRUE(server.Start());
+
+    ra::strings::StringVector args;
+    args.push_back("7");
+    processid_t pid = server.SpawnEntryPoint("exitcode", args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    int exitcode = -1;
+    ASSERT_TRUE(server.WaitExit(pid, exitcode));
+    ASSERT_EQ(7, exitcode);
+
+    args.clear();
+    args.push_back("The");
+    args.push_back("quick");
+    args.push_back("brown");
+    args.push_back("fox");
+    pid = server.SpawnEntryPoint("print", args, true);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    std::string output;
+    std::string errors;
+    ASSERT_TRUE(server.WaitExit(pid, exitcode, output, errors));
+    ASSERT_EQ(0, exitcode);
+    ASSERT_EQ(std::string("The quick brown fox"), output);
+    ASSERT_EQ(std::string("4"), errors);
+
+    //unknown entry point
+    pid = server.SpawnEntryPoint("unknown", args);
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, pid);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testGetExitCode) {
+    SpawnServer server;
+    ASSERT_TRUE(server.Start());
+
+    ra::strings::StringVector args;
+    args.push_back("1");
+    processid_t pid = server.Spawn("/bin/sleep", "", args);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    //assert GetExitCode fails while the process is running
+    int exitcode = -1;
+    ASSERT_FALSE(server.GetExitCode(pid, exitcode));
+
+    ra::timing::Millisleep(1500);
+
+    ASSERT_TRUE(server.GetExitCode(pid, exitcode));
+    ASSERT_EQ(0, exitcode);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSpawnServer, testBenchmarkLaunchRate) {
+    static const size_t NUM_LAUNCHES = 200;
+    const std::string exec_path = "/bin/true";
+    const std::string curr_dir = ra::process::GetCurrentProcessDir();
+    ra::strings::StringVector args;
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+
+    //direct StartProcess()
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_LAUNCHES; i++) {
+      processid_t pid = ra::process::StartProcess(exec_path, curr_dir, args);
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      int status = 0;
+      waitpid(pid, &status, 0);
+    }
+    double direct_elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+
+    SpawnServer server;
+    ASSERT_TRUE(server.RegisterEntryPoint("true", &EntryPointTrue));
+    ASSERT_TRUE(server.Start());
+
+    //SpawnServer::Spawn()
+    time_start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_LAUNCHES; i++) {
+      processid_t pid = server.Spawn(exec_path, curr_dir, args);
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      int exitcode = -1;
+      ASSERT_TRUE(server.WaitExit(pid, exitcode));
+    }
+    double spawn_elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+
+    //SpawnServer::SpawnEntryPoint()
+    time_start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_LAUNCHES; i++) {
+      processid_t pid = server.SpawnEntryPoint("true", args);
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      int exitcode = -1;
+      ASSERT_TRUE(server.WaitExit(pid, exitcode));
+    }
+    double entry_point_elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+
+    printf("StartProcess():                %8.1f launches per second\n", NUM_LAUNCHES / direct_elapsed);
+    printf("SpawnServer::Spawn():          %8.1f launches per second\n", NUM_LAUNCHES / spawn_elapsed);
+    printf("SpawnServer::SpawnEntryPoint(): %7.1f launches per second\n", NUM_LAUNCHES / entry_point_elapsed);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //_WIN32
+} //namespace test
+} //namespace process
+} //namespace ra